@@ -2,6 +2,10 @@
 // EMAIL: stephaniekdoan@ucla.edu
 // ID: 604981556
 
+#include "lock.h"
+#include "affinity.h"
+#include "perf.h"
+#include "pool.h"
 #include <errno.h>
 #include <getopt.h>
 #include <stdio.h>
@@ -10,11 +14,19 @@
 #include <pthread.h>
 #include <time.h>
 
+#define POOL_CHUNK_DEFAULT 64
+
 int iterations = 1;
 int opt_yield = 0;
 int opt_sync = '\0';
-pthread_mutex_t mutex; /* sync with mutex */
-volatile int lock = 0; /* sync with spin lock */
+int opt_perf = 0;
+int opt_pool = 0;   /* --pool: add on a persistent work-stealing pool of --threads workers */
+int opt_chunk = POOL_CHUNK_DEFAULT; /* --chunk=N: adds per pool task */
+int opt_repeat = 1; /* --repeat=N: run N times in one process, a CSV line each */
+pool_t pool;
+perf_counters_t *perf_arr; /* per-thread hardware counters with --perf */
+lock_t lock; /* sync with a lock of kind opt_sync */
+long long counter = 0;
 
 void print_error(char *error_string, int errnum, int exit_code)
 {
@@ -33,95 +45,116 @@ void add(long long *pointer, long long value)
     *pointer = sum;
 }
 
-void add_none(long long *counter)
-{
-    int i;
-    for (i = 0; i < iterations; ++i)
-        add((long long *)counter, 1);
-    for (i = 0; i < iterations; ++i)
-        add((long long *)counter, -1);
-}
-
-void add_mutex(long long *counter)
+void add_none(long long *counter, long long value, int n)
 {
     int i;
-    for (i = 0; i < iterations; ++i)
-    {
-        pthread_mutex_lock(&mutex);
-        add((long long *)counter, 1);
-        pthread_mutex_unlock(&mutex);
-    }
-    for (i = 0; i < iterations; ++i)
-    {
-        pthread_mutex_lock(&mutex);
-        add((long long *)counter, -1);
-        pthread_mutex_unlock(&mutex);
-    }
+    for (i = 0; i < n; ++i)
+        add((long long *)counter, value);
 }
 
-void add_spin(long long *counter)
+void add_lock(long long *counter, long long value, int n)
 {
     int i;
-    for (i = 0; i < iterations; ++i)
-    {
-        while (__sync_lock_test_and_set(&lock, 1))
-            ;
-        add((long long *)counter, 1);
-        __sync_lock_release(&lock);
-    }
-    for (i = 0; i < iterations; ++i)
+    for (i = 0; i < n; ++i)
     {
-        while (__sync_lock_test_and_set(&lock, 1))
-            ;
-        add((long long *)counter, -1);
-        __sync_lock_release(&lock);
+        lock_acquire(&lock);
+        add((long long *)counter, value);
+        lock_release(&lock);
     }
 }
 
-void add_cas(long long *counter)
+void add_cas(long long *counter, long long value, int n)
 {
     int i;
     long long old_val;
-    for (i = 0; i < iterations; ++i)
-    {
-        do
-        {
-            old_val = *counter;
-            if (opt_yield)
-                sched_yield();
-        } while (__sync_val_compare_and_swap(counter, old_val, old_val + 1) != old_val);
-    }
-    for (i = 0; i < iterations; ++i)
+    for (i = 0; i < n; ++i)
     {
         do
         {
             old_val = *counter;
             if (opt_yield)
                 sched_yield();
-        } while (__sync_val_compare_and_swap(counter, old_val, old_val - 1) != old_val);
+        } while (__sync_val_compare_and_swap(counter, old_val, old_val + value) != old_val);
     }
 }
 
-void *thread_add(void *counter)
+/* Add value to the counter n times, synchronized as --sync says */
+void add_n(long long value, int n)
 {
     switch (opt_sync)
     {
     case '\0':
-        add_none((long long *)counter);
-        break;
-    case 'm':
-        add_mutex((long long *)counter);
-        break;
-    case 's':
-        add_spin((long long *)counter);
+        add_none(&counter, value, n);
         break;
     case 'c':
-        add_cas((long long *)counter);
+        add_cas(&counter, value, n);
+        break;
+    default:
+        add_lock(&counter, value, n);
         break;
     }
+}
+
+void pin_thread(int thread_idx)
+{
+    int err = affinity_pin_self(thread_idx);
+    if (0 != err)
+        print_error("Failed to pin thread", err, 1);
+}
+
+void *thread_add(void *thread_idx)
+{
+    pin_thread((int)(long)thread_idx);
+    if (opt_perf)
+        perf_start(&perf_arr[(int)(long)thread_idx]);
+
+    add_n(1, iterations);
+    add_n(-1, iterations);
+
+    if (opt_perf)
+        perf_stop(&perf_arr[(int)(long)thread_idx]);
     return NULL;
 }
 
+/* Pool tasks: [begin, end) of the threads * iterations adds of one sign */
+void pool_increment(void *arg, int begin, int end, int worker)
+{
+    (void)arg;
+    (void)worker;
+    add_n(1, end - begin);
+}
+
+void pool_decrement(void *arg, int begin, int end, int worker)
+{
+    (void)arg;
+    (void)worker;
+    add_n(-1, end - begin);
+}
+
+/* Run on every worker around a run, as thread_add does around its adds */
+void pool_perf_start(void *arg, int worker)
+{
+    (void)arg;
+    perf_start(&perf_arr[worker]);
+}
+
+void pool_perf_stop(void *arg, int worker)
+{
+    (void)arg;
+    perf_stop(&perf_arr[worker]);
+}
+
+/* One run on the pool: all the increments, then all the decrements */
+void pool_add(int threads)
+{
+    if (opt_perf)
+        pool_each(&pool, pool_perf_start, NULL);
+    pool_run(&pool, pool_increment, NULL, threads * iterations, opt_chunk);
+    pool_run(&pool, pool_decrement, NULL, threads * iterations, opt_chunk);
+    if (opt_perf)
+        pool_each(&pool, pool_perf_stop, NULL);
+}
+
 int main(int argc, char *argv[])
 {
     static struct option long_options[] = {
@@ -129,6 +162,13 @@ int main(int argc, char *argv[])
         {"iterations", required_argument, 0, 'i'},
         {"yield", no_argument, 0, 'y'},
         {"sync", required_argument, 0, 's'},
+        {"pin", required_argument, 0, 'p'},
+        {"perf", no_argument, 0, 'P'},
+        {"spin", required_argument, 0, 'n'},
+        {"htm-retries", required_argument, 0, 'E'},
+        {"pool", no_argument, 0, 'w'},
+        {"chunk", required_argument, 0, 'k'},
+        {"repeat", required_argument, 0, 'r'},
         {0, 0, 0, 0}};
 
     int ch = 0, option_index = 0;
@@ -147,58 +187,147 @@ int main(int argc, char *argv[])
             opt_yield = 1;
             break;
         case 's':
-            if (strlen(optarg) == 1 && (optarg[0] == 'm' || optarg[0] == 's' || optarg[0] == 'c'))
+            if (strlen(optarg) == 1 && (optarg[0] == 'c' || lock_valid(optarg[0])))
                 opt_sync = optarg[0];
             else
                 print_error("Invalid argument to --sync flag", -1, 1);
             break;
+        case 'n':
+            lock_spin_limit = atoi(optarg);
+            if (lock_spin_limit < 0)
+                print_error("Invalid argument to --spin flag", -1, 1);
+            break;
+        case 'E':
+            lock_htm_retries = atoi(optarg);
+            if (lock_htm_retries < 0)
+                print_error("Invalid argument to --htm-retries flag", -1, 1);
+            break;
+        case 'p':
+            if (0 != affinity_init(optarg))
+                print_error("Invalid argument to --pin flag", -1, 1);
+            break;
+        case 'P':
+            opt_perf = 1;
+            break;
+        case 'w':
+            opt_pool = 1;
+            break;
+        case 'k':
+            opt_chunk = atoi(optarg);
+            if (opt_chunk < 1)
+                print_error("Invalid argument to --chunk flag", -1, 1);
+            break;
+        case 'r':
+            opt_repeat = atoi(optarg);
+            if (opt_repeat < 1)
+                print_error("Invalid argument to --repeat flag", -1, 1);
+            break;
         default:
             print_error("Invalid argument", -1, 1);
         }
     }
 
-    // Start clock
-    struct timespec start_ts, end_ts;
-    if (-1 == clock_gettime(CLOCK_MONOTONIC, &start_ts))
-        print_error("Failed to retrieve start time", errno, 1);
-
-    // Run threads
-    long long counter = 0;
-    pthread_t *thread_arr = malloc(sizeof(pthread_t) * threads);
-    int i;
-    for (i = 0; i < threads; ++i)
+    if (opt_sync != '\0' && opt_sync != 'c')
     {
-        if (0 != pthread_create(/*thread=*/&thread_arr[i], /**attr=*/NULL, thread_add, &counter))
-            print_error("Failed to create thread", errno, 1);
-    }
-    for (i = 0; i < threads; ++i)
-    {
-        if (0 != pthread_join(/*thread=*/thread_arr[i], NULL))
-            print_error("Failed to wait for thread to terminate", errno, 1);
+        int err = lock_init(&lock, opt_sync);
+        if (0 != err)
+            print_error("Failed to initialize lock", err, 1);
     }
+    if ('t' == opt_sync && !lock_htm_supported())
+        fprintf(stderr, "RTM is not available, so --sync=t runs on its fallback lock\n");
 
-    // End clock
-    if (-1 == clock_gettime(CLOCK_MONOTONIC, &end_ts))
-        print_error("Failed to retrieve end time", errno, 1);
-    long long total_time = (end_ts.tv_sec - start_ts.tv_sec) * 1000000000 + (end_ts.tv_nsec - start_ts.tv_nsec);
-    int ops = 2 * threads * iterations;
-    long long avg_time = total_time / ops;
+    if (opt_perf)
+        perf_arr = calloc(threads, sizeof(perf_counters_t));
 
-    // Test name
-    char test_name[20] = "add";
-    if (opt_yield)
-        strcat(test_name, "-yield");
-    if (opt_sync != '\0')
+    // Each run starts from a zero counter, on the same threads with --pool
+    pthread_t *thread_arr = malloc(sizeof(pthread_t) * threads);
+    int i, run, err;
+    if (opt_pool && 0 != (err = pool_init(&pool, threads, pin_thread)))
+        print_error("Failed to start thread pool", err, 1);
+    for (run = 0; run < opt_repeat; ++run)
     {
-        char sync_str[] = {'-', (char)opt_sync, '\0'};
-        strcat(test_name, sync_str);
-    }
-    else
-        strcat(test_name, "-none");
+        counter = 0;
+        if ('h' == opt_sync)
+            lock_hybrid_reset(&lock);
+        if ('t' == opt_sync)
+            lock_htm_reset();
+
+        // Start clock
+        struct timespec start_ts, end_ts;
+        if (-1 == clock_gettime(CLOCK_MONOTONIC, &start_ts))
+            print_error("Failed to retrieve start time", errno, 1);
+
+        // Run threads, or the pool's workers
+        if (opt_pool)
+            pool_add(threads);
+        for (i = 0; !opt_pool && i < threads; ++i)
+        {
+            if (0 != pthread_create(/*thread=*/&thread_arr[i], /**attr=*/NULL, thread_add, (void *)(long)i))
+                print_error("Failed to create thread", errno, 1);
+        }
+        for (i = 0; !opt_pool && i < threads; ++i)
+        {
+            if (0 != pthread_join(/*thread=*/thread_arr[i], NULL))
+                print_error("Failed to wait for thread to terminate", errno, 1);
+        }
 
-    printf("%s,%d,%d,%d,%lld,%lld,%lld\n", test_name, threads, iterations, ops, total_time, avg_time, counter);
+        // End clock
+        if (-1 == clock_gettime(CLOCK_MONOTONIC, &end_ts))
+            print_error("Failed to retrieve end time", errno, 1);
+        long long total_time = (end_ts.tv_sec - start_ts.tv_sec) * 1000000000 + (end_ts.tv_nsec - start_ts.tv_nsec);
+        int ops = 2 * threads * iterations;
+        long long avg_time = total_time / ops;
+
+        // Test name
+        char test_name[40] = "add";
+        if (opt_yield)
+            strcat(test_name, "-yield");
+        if (opt_sync != '\0')
+        {
+            char sync_str[] = {'-', (char)opt_sync, '\0'};
+            strcat(test_name, sync_str);
+        }
+        else
+            strcat(test_name, "-none");
+        if (opt_pool && POOL_CHUNK_DEFAULT == opt_chunk)
+            strcat(test_name, "-pool");
+        else if (opt_pool)
+            sprintf(test_name + strlen(test_name), "-pool%d", opt_chunk);
+
+        printf("%s,%d,%d,%d,%lld,%lld,%lld", test_name, threads, iterations, ops, total_time, avg_time, counter);
+        if (opt_sync == 'h')
+        {
+            // Hybrid lock: acquisitions won by spinning, and futex waits
+            long long spun = 0, parked = 0;
+            lock_hybrid_stats(&lock, &spun, &parked);
+            printf(",%lld,%lld", spun, parked);
+        }
+        if (opt_sync == 't')
+        {
+            // Elided lock: commits, aborts by cause and fallback acquisitions
+            long long events[LOCK_HTM_NEVENTS] = {0};
+            lock_htm_stats(events);
+            for (i = 0; i < LOCK_HTM_NEVENTS; ++i)
+                printf(",%lld", events[i]);
+        }
+        if (opt_perf)
+        {
+            // Hardware counters summed over all threads
+            long long totals[PERF_NEVENTS] = {0};
+            for (i = 0; i < threads; ++i)
+                perf_sum(totals, &perf_arr[i]);
+            perf_print(totals);
+        }
+        printf("\n");
+    }
 
+    if (opt_pool)
+        pool_destroy(&pool);
     free(thread_arr);
+    free(perf_arr);
+    if (opt_sync != '\0' && opt_sync != 'c')
+        lock_destroy(&lock);
+    affinity_cleanup();
 
     return 0;
 }
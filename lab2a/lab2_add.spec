@@ -0,0 +1,15 @@
+# NAME: Stephanie Doan
+# EMAIL: stephaniekdoan@ucla.edu
+# ID: 604981556
+#
+# ../lab2b/sweep.sh matrix for lab2_add.csv
+
+# lab2_add-1, lab2_add-2, lab2_add-3: unsynchronized adds, with and without yields
+./lab2_add --threads={1,2,4,8,12} --iterations={10,20,40,80,100,1000,10000,100000} {,--yield}
+
+# lab2_add-4: synchronized adds with yields (spin locks only up to 1000 iterations)
+./lab2_add --threads={2,4,8,12} --iterations={10,20,40,80,100,1000,10000} --yield --sync={m,c}
+./lab2_add --threads={2,4,8,12} --iterations={10,20,40,80,100,1000} --yield --sync=s
+
+# lab2_add-5: synchronized adds without yields
+./lab2_add --threads={1,2,4,8,12} --iterations={10,20,40,80,100,10000} --sync={m,s,c}
@@ -3,6 +3,7 @@
 // ID: 604981556
 
 #include "SortedList.h"
+#include "affinity.h"
 #include <errno.h>
 #include <getopt.h>
 #include <stdio.h>
@@ -11,11 +12,14 @@
 #include <pthread.h>
 #include <time.h>
 
+#define PAGE_SIZE 4096
+
 int iterations = 1;
 int opt_yield = 0;
 int opt_sync = '\0';
 SortedList_t list;
 SortedListElement_t *list_els;
+size_t slice_size; /* bytes from one thread's elements to the next's, whole pages with --pin */
 pthread_mutex_t mutex; /* sync with mutex */
 volatile int lock = 0; /* sync with spin lock */
 
@@ -28,8 +32,18 @@ void print_error(char *error_string, int errnum, int exit_code)
     exit(exit_code);
 }
 
+/* First of the [iterations] elements a thread inserts */
+SortedListElement_t *thread_els(int thread_idx)
+{
+    return (SortedListElement_t *)((char *)list_els + thread_idx * slice_size);
+}
+
 void *thread_list(void *start_el)
 {
+    int err = affinity_pin_self(slice_size ? ((char *)start_el - (char *)list_els) / slice_size : 0);
+    if (0 != err)
+        print_error("Failed to pin thread", err, 1);
+
     // Insert list elements
     SortedListElement_t *start = (SortedListElement_t *)start_el;
     int i;
@@ -116,9 +130,10 @@ int main(int argc, char *argv[])
         {"iterations", required_argument, 0, 'i'},
         {"yield", required_argument, 0, 'y'},
         {"sync", required_argument, 0, 's'},
+        {"pin", required_argument, 0, 'p'},
         {0, 0, 0, 0}};
 
-    int ch = 0, option_index = 0, i = 0;
+    int ch = 0, option_index = 0, i = 0, err = 0;
     int threads = 1;
     char *yieldopts = "none", *syncopts = "none";
     while ((ch = getopt_long(argc, argv, "", long_options, &option_index)) != -1)
@@ -154,20 +169,40 @@ int main(int argc, char *argv[])
             else
                 print_error("Invalid argument to --sync flag", -1, 1);
             break;
+        case 'p':
+            if (0 != affinity_init(optarg))
+                print_error("Invalid argument to --pin flag", -1, 1);
+            break;
         default:
             print_error("Invalid argument", -1, 1);
         }
     }
 
     // Initialize [threads * iterations] list elements
-    int els = threads * iterations;
-    list_els = (SortedListElement_t *)malloc(els * sizeof(SortedListElement_t));
-    for (i = 0; i < els; ++i)
+    int els = threads * iterations, t;
+    slice_size = iterations * sizeof(SortedListElement_t);
+    if (affinity_enabled())
     {
-        // Random character between ASCII 32 (space) and 126 (~)
-        char *rand_char = malloc(sizeof(char));
-        *rand_char = (rand() % (126 - 32)) + 32;
-        (list_els + i)->key = rand_char;
+        // Page-aligned, whole-page and untouched, so each thread's slice is faulted in on its own NUMA node
+        slice_size = (slice_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+        list_els = aligned_alloc(PAGE_SIZE, threads * slice_size);
+        if (!list_els)
+            print_error("Failed to allocate list elements", errno, 1);
+        err = affinity_first_touch(list_els, slice_size, threads);
+        if (0 != err)
+            print_error("Failed to place list elements", err, 1);
+    }
+    else
+        list_els = (SortedListElement_t *)malloc(els * sizeof(SortedListElement_t));
+    for (t = 0; t < threads; ++t)
+    {
+        for (i = 0; i < iterations; ++i)
+        {
+            // Random character between ASCII 32 (space) and 126 (~)
+            char *rand_char = malloc(sizeof(char));
+            *rand_char = (rand() % (126 - 32)) + 32;
+            (thread_els(t) + i)->key = rand_char;
+        }
     }
 
     // Start clock
@@ -179,7 +214,7 @@ int main(int argc, char *argv[])
     pthread_t *thread_arr = malloc(sizeof(pthread_t) * threads);
     for (i = 0; i < threads; ++i)
     {
-        if (0 != pthread_create(/*thread=*/&thread_arr[i], /**attr=*/NULL, thread_list, (void *)&list_els[i * iterations])) /* Fill in arguments */
+        if (0 != pthread_create(/*thread=*/&thread_arr[i], /**attr=*/NULL, thread_list, (void *)thread_els(i))) /* Fill in arguments */
             print_error("Failed to create thread", errno, 1);
     }
     for (i = 0; i < threads; ++i)
@@ -203,8 +238,12 @@ int main(int argc, char *argv[])
     printf("list-%s-%s,%d,%d,1,%d,%lld,%lld\n", yieldopts, syncopts, threads, iterations, ops, total_time, avg_time);
 
     free(thread_arr);
-    for (i = 0; i < els; ++i)
-        free((char *)((list_els + i)->key));
+    for (t = 0; t < threads; ++t)
+    {
+        for (i = 0; i < iterations; ++i)
+            free((char *)((thread_els(t) + i)->key));
+    }
     free(list_els);
+    affinity_cleanup();
     return 0;
 }
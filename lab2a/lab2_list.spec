@@ -0,0 +1,18 @@
+# NAME: Stephanie Doan
+# EMAIL: stephaniekdoan@ucla.edu
+# ID: 604981556
+#
+# ../lab2b/sweep.sh matrix for lab2_list.csv
+
+# lab2_list-1: single-threaded cost per operation
+./lab2_list --threads=1 --iterations={10,100,1000,10000,20000}
+
+# lab2_list-2: unprotected runs that finish without corrupting the list; correctness probes, so one run each
+runs=1 warmup=0 ./lab2_list --threads={2,4,8,12} --iterations={10,100,1000}
+runs=1 warmup=0 ./lab2_list --threads={2,4,8,12} --iterations={1,2,4,8,16,32} {,--yield=i,--yield=d,--yield=il,--yield=dl}
+
+# lab2_list-3: protected runs with yields
+runs=1 warmup=0 ./lab2_list --threads={2,4,8,12} --iterations={1,10,100,1000} {,--yield=i,--yield=d,--yield=il,--yield=dl} --sync={m,s}
+
+# lab2_list-4: scalability of synchronization
+./lab2_list --threads={1,2,4,8,12,16,24} --iterations=1000 --sync={m,s}
@@ -0,0 +1,121 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "FineList.h"
+#include "lock.h"
+#include <sched.h>
+#include <string.h>
+
+/* Holding an element's lock pins its next pointer and keeps its
+ * successor from being unlinked, so a thread holding pred may read
+ * cur's key, and must lock cur before letting go of pred. */
+
+void FineList_insert(SortedList_t *list, SortedListElement_t *element)
+{
+    if (!list || !element)
+        return;
+
+    SortedListElement_t *pred = list, *cur;
+    spin_acquire(&locked_element(pred)->lock);
+    cur = pred->next;
+    while (cur && strcmp(cur->key, element->key) < 0)
+    {
+        spin_acquire(&locked_element(cur)->lock);
+        spin_release(&locked_element(pred)->lock);
+        pred = cur;
+        cur = cur->next;
+    }
+
+    if (opt_yield & INSERT_YIELD)
+        sched_yield();
+
+    element->next = cur;
+    pred->next = element;
+    spin_release(&locked_element(pred)->lock);
+}
+
+int FineList_delete(SortedList_t *list, SortedListElement_t *element)
+{
+    if (!list || !element)
+        return 1;
+
+    SortedListElement_t *pred = list, *cur;
+    spin_acquire(&locked_element(pred)->lock);
+    cur = pred->next;
+    while (cur && cur != element)
+    {
+        if (strcmp(cur->key, element->key) > 0)
+        {
+            cur = NULL;
+            break;
+        }
+        spin_acquire(&locked_element(cur)->lock);
+        spin_release(&locked_element(pred)->lock);
+        pred = cur;
+        cur = cur->next;
+    }
+    if (!cur)
+    {
+        spin_release(&locked_element(pred)->lock);
+        return 1;
+    }
+
+    // Lock the victim too, so nobody is changing its next pointer
+    spin_acquire(&locked_element(cur)->lock);
+    if (opt_yield & DELETE_YIELD)
+        sched_yield();
+    pred->next = cur->next;
+    spin_release(&locked_element(cur)->lock);
+    spin_release(&locked_element(pred)->lock);
+    return 0;
+}
+
+SortedListElement_t *FineList_lookup(SortedList_t *list, const char *key)
+{
+    if (!list || !key)
+        return NULL;
+
+    SortedListElement_t *pred = list, *cur;
+    spin_acquire(&locked_element(pred)->lock);
+    cur = pred->next;
+    while (cur && cur->key != key)
+    {
+        if (strcmp(cur->key, key) > 0)
+        {
+            cur = NULL;
+            break;
+        }
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        spin_acquire(&locked_element(cur)->lock);
+        spin_release(&locked_element(pred)->lock);
+        pred = cur;
+        cur = cur->next;
+    }
+    spin_release(&locked_element(pred)->lock);
+    return cur;
+}
+
+int FineList_length(SortedList_t *list)
+{
+    if (!list)
+        return -1;
+
+    int length = 0;
+    SortedListElement_t *pred = list, *cur;
+    spin_acquire(&locked_element(pred)->lock);
+    cur = pred->next;
+    while (cur)
+    {
+        ++length;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        spin_acquire(&locked_element(cur)->lock);
+        spin_release(&locked_element(pred)->lock);
+        pred = cur;
+        cur = cur->next;
+    }
+    spin_release(&locked_element(pred)->lock);
+    return length;
+}
@@ -0,0 +1,48 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef FINELIST_H
+#define FINELIST_H
+
+#include "SortedListExt.h"
+
+/**
+ * FineList
+ *
+ *	A sorted list with one lock per element, traversed hand-over-hand
+ *	(lock coupling): a thread locks the next element before unlocking
+ *	the current one, so threads working on different parts of a list
+ *	pass each other instead of serializing on one list lock.
+ *
+ *	Like LockFreeList it is singly linked and NULL-terminated: prev
+ *	pointers are unused and a zeroed head is a valid empty list. Keys
+ *	are compared with strcmp. The head and every element must be a
+ *	LockedListElement_t, whose lock the traversal takes.
+ */
+
+/**
+ * FineList_insert ... insert an element, keeping the list sorted
+ */
+void FineList_insert(SortedList_t *list, SortedListElement_t *element);
+
+/**
+ * FineList_delete ... remove an element from a list
+ *
+ * @return 0: element deleted, 1: element not found in the list
+ */
+int FineList_delete(SortedList_t *list, SortedListElement_t *element);
+
+/**
+ * FineList_lookup ... find the element whose key is this exact pointer
+ *
+ * @return pointer to matching element, or NULL if none is found
+ */
+SortedListElement_t *FineList_lookup(SortedList_t *list, const char *key);
+
+/**
+ * FineList_length ... count elements in a list
+ */
+int FineList_length(SortedList_t *list);
+
+#endif
@@ -0,0 +1,257 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "HashTable.h"
+#include "epoch.h"
+#include "lock.h"
+#include "timer.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE 64
+
+/* A bucket's lock, list and size share a cache line of their own */
+typedef struct hash_bucket
+{
+    lock_t lock;
+    SortedList_t head;
+    int count;     /* elements in head, guarded by lock */
+    int forwarded; /* moved to the next array by a resize, guarded by lock */
+} __attribute__((aligned(CACHE_LINE))) hash_bucket_t;
+
+struct hash_array
+{
+    int nbuckets;
+    struct hash_array *volatile next; /* twice as large, while a resize is moving buckets into it */
+    hash_bucket_t buckets[];
+};
+
+static __thread long long lock_wait = 0;
+
+static void array_free(void *ptr)
+{
+    struct hash_array *array = ptr;
+    int i;
+    for (i = 0; i < array->nbuckets; ++i)
+        lock_destroy(&array->buckets[i].lock);
+    free(array);
+}
+
+static struct hash_array *array_alloc(int nbuckets, int lock_kind)
+{
+    size_t size = sizeof(struct hash_array) + nbuckets * sizeof(hash_bucket_t);
+    size = (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    struct hash_array *array = aligned_alloc(CACHE_LINE, size);
+    if (!array)
+        return NULL;
+    memset(array, 0, size);
+    for (array->nbuckets = 0; array->nbuckets < nbuckets; ++array->nbuckets)
+    {
+        hash_bucket_t *bucket = &array->buckets[array->nbuckets];
+        // Circular empty list, so a bucket that never sees an insert still has a length
+        bucket->head.next = &bucket->head;
+        bucket->head.prev = &bucket->head;
+        int err = lock_init(&bucket->lock, lock_kind);
+        if (0 != err)
+        {
+            array_free(array);
+            errno = err;
+            return NULL;
+        }
+    }
+    return array;
+}
+
+/* Spin lock waits go untimed, as the driver's sublist locks do */
+static void bucket_acquire(HashTable_t *table, hash_bucket_t *bucket)
+{
+    if ('s' == table->lock_kind || !timer_sampled())
+    {
+        lock_acquire(&bucket->lock);
+        return;
+    }
+    unsigned long long start = timer_now();
+    lock_acquire(&bucket->lock);
+    lock_wait += timer_ns(timer_now() - start) * timer_sample;
+}
+
+/**
+ * Lock the bucket that key hashes to. If a resize has already moved
+ * that bucket, follow it into the larger array. Must be called inside
+ * an epoch critical section; only one bucket lock is held at a time.
+ */
+static hash_bucket_t *bucket_lock(HashTable_t *table, const char *key, struct hash_array **parray)
+{
+    unsigned hash = table->hash(key);
+    struct hash_array *array = __atomic_load_n(&table->array, __ATOMIC_ACQUIRE);
+    for (;;)
+    {
+        hash_bucket_t *bucket = &array->buckets[hash % array->nbuckets];
+        bucket_acquire(table, bucket);
+        if (!bucket->forwarded)
+        {
+            *parray = array;
+            return bucket;
+        }
+        lock_release(&bucket->lock);
+        array = __atomic_load_n(&array->next, __ATOMIC_ACQUIRE);
+    }
+}
+
+/**
+ * Double the bucket array if it is over its load factor. Buckets are
+ * moved one at a time, so other threads only ever wait for the bucket
+ * being moved; until it is moved, they keep using the old one.
+ */
+static void resize(HashTable_t *table, struct hash_array *array)
+{
+    int i;
+    long long total = 0;
+    for (i = 0; i < array->nbuckets; ++i)
+        total += __atomic_load_n(&array->buckets[i].count, __ATOMIC_RELAXED);
+    if (total <= (long long)HASHTABLE_LOAD_FACTOR * array->nbuckets ||
+        __atomic_load_n(&array->next, __ATOMIC_RELAXED) || __atomic_load_n(&table->array, __ATOMIC_RELAXED) != array)
+        return;
+
+    struct hash_array *grown = array_alloc(2 * array->nbuckets, table->lock_kind), *expected = NULL;
+    if (!grown)
+        return; // keep the smaller table and try again at the next threshold
+    if (!__atomic_compare_exchange_n(&array->next, &expected, grown, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    {
+        array_free(grown); // another thread is already resizing
+        return;
+    }
+
+    unsigned long long start = timer_now();
+    long long pause_max = 0;
+    for (i = 0; i < array->nbuckets; ++i)
+    {
+        // Old bucket i only feeds new buckets i and i + nbuckets, which nobody
+        // can reach until it is marked forwarded, so they need no locking
+        hash_bucket_t *bucket = &array->buckets[i];
+        bucket_acquire(table, bucket);
+        unsigned long long pause_start = timer_now();
+        while (bucket->head.next != &bucket->head)
+        {
+            SortedListElement_t *element = bucket->head.next;
+            SortedList_delete(element);
+            hash_bucket_t *target = &grown->buckets[table->hash(element->key) % grown->nbuckets];
+            SortedList_insert(&target->head, element);
+            ++target->count;
+        }
+        bucket->count = 0;
+        bucket->forwarded = 1;
+        long long pause = timer_ns(timer_now() - pause_start);
+        lock_release(&bucket->lock);
+        if (pause > pause_max)
+            pause_max = pause;
+    }
+
+    // The next resize can only start once grown is published, so these need no lock
+    ++table->resizes;
+    table->resize_time += timer_ns(timer_now() - start);
+    if (pause_max > table->pause_max)
+        table->pause_max = pause_max;
+    __atomic_store_n(&table->array, grown, __ATOMIC_RELEASE);
+    epoch_retire(array, array_free);
+}
+
+int HashTable_init(HashTable_t *table, int buckets, int lock_kind, unsigned (*hash)(const char *key))
+{
+    if (buckets < 1 || !lock_valid(lock_kind))
+        return EINVAL;
+    memset(table, 0, sizeof(HashTable_t));
+    table->lock_kind = lock_kind;
+    table->hash = hash;
+    table->array = array_alloc(buckets, lock_kind);
+    return table->array ? 0 : errno;
+}
+
+void HashTable_destroy(HashTable_t *table)
+{
+    if (table->array)
+        array_free(table->array);
+    table->array = NULL;
+}
+
+void HashTable_insert(HashTable_t *table, SortedListElement_t *element)
+{
+    struct hash_array *array;
+    if (!table || !element)
+        return;
+
+    epoch_enter();
+    hash_bucket_t *bucket = bucket_lock(table, element->key, &array);
+    SortedList_insert(&bucket->head, element);
+    int count = ++bucket->count;
+    lock_release(&bucket->lock);
+
+    // Only add up the whole table when a bucket reaches a power of two
+    if (count > HASHTABLE_LOAD_FACTOR && !(count & (count - 1)))
+        resize(table, array);
+    epoch_exit();
+}
+
+int HashTable_delete(HashTable_t *table, SortedListElement_t *element)
+{
+    struct hash_array *array;
+    if (!table || !element)
+        return 1;
+
+    epoch_enter();
+    hash_bucket_t *bucket = bucket_lock(table, element->key, &array);
+    int ret = SortedList_delete(element);
+    if (0 == ret)
+        --bucket->count;
+    lock_release(&bucket->lock);
+    epoch_exit();
+    return ret;
+}
+
+SortedListElement_t *HashTable_lookup(HashTable_t *table, const char *key)
+{
+    struct hash_array *array;
+    if (!table || !key)
+        return NULL;
+
+    epoch_enter();
+    hash_bucket_t *bucket = bucket_lock(table, key, &array);
+    SortedListElement_t *element = SortedList_lookup(&bucket->head, key);
+    lock_release(&bucket->lock);
+    epoch_exit();
+    return element;
+}
+
+int HashTable_length(HashTable_t *table)
+{
+    int i, length = 0;
+    if (!table)
+        return -1;
+
+    epoch_enter();
+    struct hash_array *array = __atomic_load_n(&table->array, __ATOMIC_ACQUIRE);
+    for (i = 0; i < array->nbuckets && length >= 0; ++i)
+    {
+        hash_bucket_t *bucket = &array->buckets[i];
+        bucket_acquire(table, bucket);
+        int bucket_length = SortedList_length(&bucket->head);
+        lock_release(&bucket->lock);
+        length = bucket_length < 0 ? -1 : length + bucket_length;
+    }
+    epoch_exit();
+    return length;
+}
+
+int HashTable_buckets(HashTable_t *table)
+{
+    return __atomic_load_n(&table->array, __ATOMIC_ACQUIRE)->nbuckets;
+}
+
+long long HashTable_lock_wait(void)
+{
+    long long wait = lock_wait;
+    lock_wait = 0;
+    return wait;
+}
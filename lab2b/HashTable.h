@@ -0,0 +1,106 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
+#include "SortedListExt.h"
+
+/* Average elements per bucket above which the table doubles */
+#define HASHTABLE_LOAD_FACTOR 4
+
+struct hash_array;
+
+/**
+ * HashTable
+ *
+ *	A concurrent hash table of SortedListElement_t. Each bucket is a
+ *	sorted SortedList guarded by its own lock_t, of the kind given at
+ *	initialization, and elements go to bucket hash(key) % buckets.
+ *
+ *	The table starts with the requested number of buckets and doubles
+ *	whenever the average bucket holds more than HASHTABLE_LOAD_FACTOR
+ *	elements. The inserting thread that notices does the resize, moving
+ *	one bucket at a time into the new array while other threads keep
+ *	working; a thread only waits if it needs the bucket being moved.
+ *	Old bucket arrays are freed through epoch reclamation (see epoch.h),
+ *	since threads may still be waiting on their locks.
+ *
+ *	Every operation holds at most one bucket lock, so any kind of lock
+ *	works, including the q and l queue locks.
+ */
+typedef struct HashTable
+{
+    struct hash_array *volatile array;
+    int lock_kind;
+    unsigned (*hash)(const char *key);
+    /* Updated by the resizing thread; only one resize runs at a time */
+    long long resizes;
+    long long resize_time; /* total ns spent resizing */
+    long long pause_max;   /* longest ns a bucket was locked for moving */
+} HashTable_t;
+
+/**
+ * HashTable_init ... initialize an empty hash table
+ *
+ * @param table to be initialized
+ * @param buckets initial number of buckets (at least 1)
+ * @param lock_kind bucket lock kind, one of LOCK_KINDS in lock.h
+ * @param hash hash function over a NUL-terminated key
+ *
+ * @return 0 on success, or an error number
+ */
+int HashTable_init(HashTable_t *table, int buckets, int lock_kind, unsigned (*hash)(const char *key));
+
+/**
+ * HashTable_destroy ... free the buckets of an unused hash table
+ *
+ *	Elements still in the table are not freed. Call epoch_barrier
+ *	first to release bucket arrays left over from resizes.
+ */
+void HashTable_destroy(HashTable_t *table);
+
+/**
+ * HashTable_insert ... insert an element into its bucket, keeping it sorted
+ */
+void HashTable_insert(HashTable_t *table, SortedListElement_t *element);
+
+/**
+ * HashTable_delete ... remove an element from its bucket
+ *
+ * @return 0: element deleted, 1: corrupted prev/next pointers
+ */
+int HashTable_delete(HashTable_t *table, SortedListElement_t *element);
+
+/**
+ * HashTable_lookup ... find the element whose key is this exact pointer
+ *
+ * @return pointer to matching element, or NULL if none is found
+ */
+SortedListElement_t *HashTable_lookup(HashTable_t *table, const char *key);
+
+/**
+ * HashTable_length ... count elements, locking one bucket at a time
+ *
+ *	The count is only exact when no other thread is modifying the table.
+ *
+ * @return number of elements, or -1 if a bucket is corrupted
+ */
+int HashTable_length(HashTable_t *table);
+
+/**
+ * HashTable_buckets ... current number of buckets
+ */
+int HashTable_buckets(HashTable_t *table);
+
+/**
+ * HashTable_lock_wait ... time the calling thread has spent waiting
+ *	for bucket locks (ns), reset to 0 by each call
+ *
+ *	Waits are timed with timer.h, one in every timer_sample; spin
+ *	lock (s) waits are not timed at all.
+ */
+long long HashTable_lock_wait(void);
+
+#endif
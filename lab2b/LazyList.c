@@ -0,0 +1,128 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "LazyList.h"
+#include "lock.h"
+#include <sched.h>
+#include <string.h>
+
+/* Both elements are locked: check that neither was deleted and that
+ * pred still points at cur (cur may be NULL, the end of the list) */
+static int validate(SortedListElement_t *pred, SortedListElement_t *cur)
+{
+    return !locked_element(pred)->marked && (!cur || !locked_element(cur)->marked) && pred->next == cur;
+}
+
+void LazyList_insert(SortedList_t *list, SortedListElement_t *element)
+{
+    if (!list || !element)
+        return;
+
+    for (;;)
+    {
+        SortedListElement_t *pred = list;
+        SortedListElement_t *cur = __atomic_load_n(&pred->next, __ATOMIC_ACQUIRE);
+        while (cur && strcmp(cur->key, element->key) < 0)
+        {
+            pred = cur;
+            cur = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+        }
+
+        if (opt_yield & INSERT_YIELD)
+            sched_yield();
+
+        spin_acquire(&locked_element(pred)->lock);
+        if (cur)
+            spin_acquire(&locked_element(cur)->lock);
+        int valid = validate(pred, cur);
+        if (valid)
+        {
+            locked_element(element)->marked = 0;
+            element->next = cur;
+            // Publish the initialized element to lock-free readers
+            __atomic_store_n(&pred->next, element, __ATOMIC_RELEASE);
+        }
+        if (cur)
+            spin_release(&locked_element(cur)->lock);
+        spin_release(&locked_element(pred)->lock);
+        if (valid)
+            return;
+    }
+}
+
+int LazyList_delete(SortedList_t *list, SortedListElement_t *element)
+{
+    if (!list || !element)
+        return 1;
+
+    for (;;)
+    {
+        SortedListElement_t *pred = list;
+        SortedListElement_t *cur = __atomic_load_n(&pred->next, __ATOMIC_ACQUIRE);
+        while (cur && cur != element && strcmp(cur->key, element->key) <= 0)
+        {
+            pred = cur;
+            cur = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+        }
+        if (cur != element)
+            return 1;
+
+        if (opt_yield & DELETE_YIELD)
+            sched_yield();
+
+        spin_acquire(&locked_element(pred)->lock);
+        spin_acquire(&locked_element(cur)->lock);
+        int result = -1;
+        if (locked_element(cur)->marked)
+            result = 1;
+        else if (validate(pred, cur))
+        {
+            // Logical delete first, so readers stop returning it
+            __atomic_store_n(&locked_element(cur)->marked, 1, __ATOMIC_RELEASE);
+            __atomic_store_n(&pred->next, cur->next, __ATOMIC_RELEASE);
+            result = 0;
+        }
+        spin_release(&locked_element(cur)->lock);
+        spin_release(&locked_element(pred)->lock);
+        if (result >= 0)
+            return result;
+    }
+}
+
+SortedListElement_t *LazyList_lookup(SortedList_t *list, const char *key)
+{
+    if (!list || !key)
+        return NULL;
+
+    SortedListElement_t *cur = __atomic_load_n(&list->next, __ATOMIC_ACQUIRE);
+    while (cur)
+    {
+        if (cur->key == key && !__atomic_load_n(&locked_element(cur)->marked, __ATOMIC_ACQUIRE))
+            return cur;
+        if (strcmp(cur->key, key) > 0)
+            return NULL;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        cur = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+    }
+    return NULL;
+}
+
+int LazyList_length(SortedList_t *list)
+{
+    if (!list)
+        return -1;
+
+    int length = 0;
+    SortedListElement_t *cur = __atomic_load_n(&list->next, __ATOMIC_ACQUIRE);
+    while (cur)
+    {
+        if (!__atomic_load_n(&locked_element(cur)->marked, __ATOMIC_ACQUIRE))
+            ++length;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        cur = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+    }
+    return length;
+}
@@ -0,0 +1,50 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef LAZYLIST_H
+#define LAZYLIST_H
+
+#include "SortedListExt.h"
+
+/**
+ * LazyList
+ *
+ *	The optimistic "lazy" list of Heller et al.: insert and delete
+ *	walk the list without locks, then lock only the two elements they
+ *	change and validate that neither has been deleted and that they
+ *	are still adjacent, retrying if not. Delete sets the element's
+ *	marked flag before unlinking it, so lookup and length never lock
+ *	and never retry (they are wait-free).
+ *
+ *	Singly linked and NULL-terminated, and made of LockedListElement_t,
+ *	like FineList. An unlinked element may still be visited by
+ *	concurrent traversals, so it must not be reused while other threads
+ *	may be using the list.
+ */
+
+/**
+ * LazyList_insert ... insert an element, keeping the list sorted
+ */
+void LazyList_insert(SortedList_t *list, SortedListElement_t *element);
+
+/**
+ * LazyList_delete ... remove an element from a list
+ *
+ * @return 0: element deleted, 1: element not found or already deleted
+ */
+int LazyList_delete(SortedList_t *list, SortedListElement_t *element);
+
+/**
+ * LazyList_lookup ... find the live element whose key is this exact pointer
+ *
+ * @return pointer to matching element, or NULL if none is found
+ */
+SortedListElement_t *LazyList_lookup(SortedList_t *list, const char *key);
+
+/**
+ * LazyList_length ... count elements that are not marked deleted
+ */
+int LazyList_length(SortedList_t *list);
+
+#endif
@@ -0,0 +1,165 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "LockFreeList.h"
+#include "epoch.h"
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+
+void (*LockFreeList_free)(void *element) = NULL;
+
+/* The low bit of an element's next pointer marks the element deleted */
+static int is_marked(SortedListElement_t *p)
+{
+    return (uintptr_t)p & 1;
+}
+
+static SortedListElement_t *with_mark(SortedListElement_t *p)
+{
+    return (SortedListElement_t *)((uintptr_t)p | 1);
+}
+
+static SortedListElement_t *without_mark(SortedListElement_t *p)
+{
+    return (SortedListElement_t *)((uintptr_t)p & ~(uintptr_t)1);
+}
+
+/**
+ * Walk to the insertion point for key: on return *pcur is the first
+ * live element whose key is >= key (or, when target is given, target
+ * itself or the first element whose key is > key), and the returned
+ * pointer is the next field that points at it. Marked elements passed
+ * on the way are unlinked.
+ */
+static SortedListElement_t **find(SortedList_t *list, const char *key, SortedListElement_t *target,
+                                  SortedListElement_t **pcur)
+{
+    SortedListElement_t **prev, *cur, *next;
+retry:
+    prev = &list->next;
+    cur = __atomic_load_n(prev, __ATOMIC_ACQUIRE);
+    while (cur)
+    {
+        next = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+        if (is_marked(next))
+        {
+            // Unlink cur; fails if *prev changed or its owner was marked
+            SortedListElement_t *expected = cur;
+            if (!__atomic_compare_exchange_n(prev, &expected, without_mark(next), 0,
+                                             __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                goto retry;
+            if (LockFreeList_free)
+                epoch_retire(cur, LockFreeList_free);
+            cur = without_mark(next);
+            continue;
+        }
+        if (cur == target)
+            break;
+        int cmp = strcmp(cur->key, key);
+        if (target ? cmp > 0 : cmp >= 0)
+            break;
+        prev = &cur->next;
+        cur = next;
+    }
+    *pcur = cur;
+    return prev;
+}
+
+void LockFreeList_insert(SortedList_t *list, SortedListElement_t *element)
+{
+    SortedListElement_t **prev, *cur;
+    if (!list || !element)
+        return;
+    if (LockFreeList_free)
+        epoch_enter();
+    do
+    {
+        prev = find(list, element->key, NULL, &cur);
+        element->next = cur;
+        if (opt_yield & INSERT_YIELD)
+            sched_yield();
+    } while (!__atomic_compare_exchange_n(prev, &cur, element, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    if (LockFreeList_free)
+        epoch_exit();
+}
+
+int LockFreeList_delete(SortedList_t *list, SortedListElement_t *element)
+{
+    SortedListElement_t *next, *cur;
+    if (!list || !element)
+        return 1;
+    if (LockFreeList_free)
+        epoch_enter();
+    next = __atomic_load_n(&element->next, __ATOMIC_ACQUIRE);
+    do
+    {
+        if (is_marked(next))
+        {
+            if (LockFreeList_free)
+                epoch_exit();
+            return 1;
+        }
+    } while (!__atomic_compare_exchange_n(&element->next, &next, with_mark(next), 0,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    if (opt_yield & DELETE_YIELD)
+        sched_yield();
+
+    // Unlink it now rather than leaving that to the next traversal
+    find(list, element->key, element, &cur);
+    if (LockFreeList_free)
+        epoch_exit();
+    return 0;
+}
+
+SortedListElement_t *LockFreeList_lookup(SortedList_t *list, const char *key)
+{
+    SortedListElement_t *cur, *found = NULL;
+    if (!list || !key)
+        return NULL;
+    if (LockFreeList_free)
+        epoch_enter();
+    cur = __atomic_load_n(&list->next, __ATOMIC_ACQUIRE);
+    while (cur)
+    {
+        SortedListElement_t *next = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+        if (cur->key == key && !is_marked(next))
+        {
+            found = cur;
+            break;
+        }
+        if (strcmp(cur->key, key) > 0)
+            break;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        cur = without_mark(next);
+    }
+    if (LockFreeList_free)
+        epoch_exit();
+    return found;
+}
+
+int LockFreeList_length(SortedList_t *list)
+{
+    SortedListElement_t *cur;
+    int length = 0;
+    if (!list)
+        return -1;
+    if (LockFreeList_free)
+        epoch_enter();
+    cur = __atomic_load_n(&list->next, __ATOMIC_ACQUIRE);
+    while (cur)
+    {
+        SortedListElement_t *next = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+        if (!is_marked(next))
+            ++length;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        cur = without_mark(next);
+    }
+    if (LockFreeList_free)
+        epoch_exit();
+    return length;
+}
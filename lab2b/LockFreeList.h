@@ -0,0 +1,63 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef LOCKFREELIST_H
+#define LOCKFREELIST_H
+
+#include "SortedListExt.h"
+
+/**
+ * LockFreeList
+ *
+ *	A lock-free sorted list (Harris, with Michael's one-node-at-a-time
+ *	unlinking) over the same SortedListElement_t and list head as
+ *	SortedList. It is singly linked: prev pointers are unused, and an
+ *	empty list is a head whose next pointer is NULL, so a zeroed head
+ *	is a valid empty list.
+ *
+ *	A node is deleted by setting the low bit of its next pointer
+ *	(logical delete) and is then unlinked by whichever thread next
+ *	walks past it. Keys are compared with strcmp.
+ *
+ *	If LockFreeList_free is set, every operation runs in an epoch
+ *	critical section and each unlinked element is passed to it once
+ *	no thread can still be traversing it (see epoch.h). Callers that
+ *	keep their elements alive for the lifetime of the list can leave
+ *	it NULL and skip the epoch bookkeeping.
+ */
+extern void (*LockFreeList_free)(void *element);
+
+/**
+ * LockFreeList_insert ... insert an element, keeping the list sorted
+ */
+void LockFreeList_insert(SortedList_t *list, SortedListElement_t *element);
+
+/**
+ * LockFreeList_delete ... remove an element from a list
+ *
+ *	Unlike SortedList_delete this needs the list head, to unlink
+ *	the element after marking it.
+ *
+ * @return 0: element deleted, 1: element was already deleted
+ */
+int LockFreeList_delete(SortedList_t *list, SortedListElement_t *element);
+
+/**
+ * LockFreeList_lookup ... find the element whose key is this exact pointer
+ *
+ *	Like SortedList_lookup, elements are matched by key pointer.
+ *	Lookups never write to the list.
+ *
+ * @return pointer to matching element, or NULL if none is found
+ */
+SortedListElement_t *LockFreeList_lookup(SortedList_t *list, const char *key);
+
+/**
+ * LockFreeList_length ... count elements that are not marked deleted
+ *
+ *	The count is only exact when no other thread is modifying the list.
+ */
+int LockFreeList_length(SortedList_t *list);
+
+#endif
@@ -0,0 +1,82 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "RcuList.h"
+#include "epoch.h"
+#include <sched.h>
+#include <string.h>
+
+void RcuList_insert(SortedList_t *list, SortedListElement_t *element)
+{
+    if (!list || !element)
+        return;
+
+    SortedList_t *cur = list->next;
+    while (cur != list && strcmp(element->key, cur->key) > 0)
+        cur = cur->next;
+
+    if (opt_yield & INSERT_YIELD)
+        sched_yield();
+
+    element->prev = cur->prev;
+    element->next = cur;
+    // Publish the initialized element to lock-free readers; prev is only followed by writers
+    __atomic_store_n(&cur->prev->next, element, __ATOMIC_RELEASE);
+    cur->prev = element;
+}
+
+int RcuList_delete(SortedListElement_t *element)
+{
+    if (!element || element->next->prev != element || element->prev->next != element)
+        return 1;
+
+    if (opt_yield & DELETE_YIELD)
+        sched_yield();
+
+    element->next->prev = element->prev;
+    __atomic_store_n(&element->prev->next, element->next, __ATOMIC_RELEASE);
+    return 0;
+}
+
+SortedListElement_t *RcuList_lookup(SortedList_t *list, const char *key)
+{
+    SortedListElement_t *found = NULL;
+    if (!list || !list->next)
+        return NULL;
+
+    epoch_enter();
+    SortedList_t *cur = __atomic_load_n(&list->next, __ATOMIC_ACQUIRE);
+    while (cur != list)
+    {
+        if (key == cur->key)
+        {
+            found = cur;
+            break;
+        }
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        cur = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+    }
+    epoch_exit();
+    return found;
+}
+
+int RcuList_length(SortedList_t *list)
+{
+    int length = 0;
+    if (!list)
+        return -1;
+
+    epoch_enter();
+    SortedList_t *cur = __atomic_load_n(&list->next, __ATOMIC_ACQUIRE);
+    while (cur != list)
+    {
+        ++length;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        cur = __atomic_load_n(&cur->next, __ATOMIC_ACQUIRE);
+    }
+    epoch_exit();
+    return length;
+}
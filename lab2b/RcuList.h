@@ -0,0 +1,61 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef RCULIST_H
+#define RCULIST_H
+
+#include "SortedListExt.h"
+
+/**
+ * RcuList
+ *
+ *	A read-copy-update flavour of SortedList for read-mostly use:
+ *	writers still serialize on a lock of the caller's, but lookup and
+ *	length take no lock at all. A writer fills in a new element's
+ *	pointers first and only then links it in with a release store,
+ *	and delete unlinks an element with one release store while
+ *	leaving its own next pointer intact, so a reader that is standing
+ *	on it when it goes still finds its way back into the list.
+ *
+ *	Readers run inside an epoch critical section (see epoch.h), so a
+ *	deleted element may only be reused or freed once every reader
+ *	that might still see it has left, e.g. through epoch_retire.
+ *	Uses the circular SortedList layout; the head must be initialized
+ *	to point at itself before the first reader arrives.
+ */
+
+/**
+ * RcuList_insert ... insert an element, keeping the list sorted
+ *
+ *	The caller holds the list's write lock.
+ */
+void RcuList_insert(SortedList_t *list, SortedListElement_t *element);
+
+/**
+ * RcuList_delete ... remove an element from a list
+ *
+ *	The caller holds the list's write lock.
+ *
+ * @return 0: element deleted, 1: corrupted prev/next pointers
+ */
+int RcuList_delete(SortedListElement_t *element);
+
+/**
+ * RcuList_lookup ... find the element whose key is this exact pointer, without locking
+ *
+ * @return pointer to matching element, or NULL if none is found
+ */
+SortedListElement_t *RcuList_lookup(SortedList_t *list, const char *key);
+
+/**
+ * RcuList_length ... count elements, without locking
+ *
+ *	Exact only while the caller holds the write lock; otherwise a
+ *	snapshot that may miss concurrent inserts and deletes.
+ *
+ * @return number of elements in list, or -1 if list is NULL
+ */
+int RcuList_length(SortedList_t *list);
+
+#endif
@@ -0,0 +1,275 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "SkipList.h"
+#include "epoch.h"
+#include "lock.h"
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct skip_node
+{
+    SortedListElement_t *element; /* NULL for the head */
+    volatile int lock;
+    volatile int marked;       /* logically deleted */
+    volatile int fully_linked; /* linked at every level of its tower */
+    int height;
+    struct skip_node *next[]; /* height entries */
+} skip_node_t;
+
+static __thread uint64_t rng_state = 0;
+
+/* Geometric height with p = 1/2, from a per-thread xorshift generator */
+static int random_height(void)
+{
+    if (!rng_state)
+        rng_state = (uintptr_t)&rng_state | 1;
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    int height = 1 + __builtin_ctzll(rng_state | (1ULL << (SKIPLIST_MAX_LEVEL - 1)));
+    return height;
+}
+
+static skip_node_t *node_alloc(SortedListElement_t *element, int height)
+{
+    skip_node_t *node = calloc(1, sizeof(skip_node_t) + height * sizeof(skip_node_t *));
+    if (!node)
+        abort();
+    node->element = element;
+    node->height = height;
+    return node;
+}
+
+/* Order by key, then by key address; the head sorts before everything */
+static int node_cmp(skip_node_t *node, const char *key)
+{
+    int cmp = strcmp(node->element->key, key);
+    if (cmp)
+        return cmp;
+    if (node->element->key == key)
+        return 0;
+    return (uintptr_t)node->element->key < (uintptr_t)key ? -1 : 1;
+}
+
+static skip_node_t *load_next(skip_node_t *node, int level)
+{
+    return __atomic_load_n(&node->next[level], __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Fill preds/succs with the nodes around key at every level, without
+ * locking. Returns the highest level at which succs holds the node for
+ * key, or -1 if there is none.
+ */
+static int find(SkipList_t *list, const char *key, skip_node_t **preds, skip_node_t **succs)
+{
+    int found = -1, level;
+    skip_node_t *pred = list->head, *cur;
+    for (level = SKIPLIST_MAX_LEVEL - 1; level >= 0; --level)
+    {
+        cur = load_next(pred, level);
+        while (cur && node_cmp(cur, key) < 0)
+        {
+            pred = cur;
+            cur = load_next(pred, level);
+        }
+        if (found == -1 && cur && cur->element->key == key)
+            found = level;
+        preds[level] = pred;
+        succs[level] = cur;
+    }
+    return found;
+}
+
+/* Unlock preds[0..highest], each distinct node once */
+static void unlock_preds(skip_node_t **preds, int highest)
+{
+    skip_node_t *prev = NULL;
+    int level;
+    for (level = 0; level <= highest; ++level)
+    {
+        if (preds[level] != prev)
+            spin_release(&preds[level]->lock);
+        prev = preds[level];
+    }
+}
+
+int SkipList_init(SkipList_t *list)
+{
+    list->head = calloc(1, sizeof(skip_node_t) + SKIPLIST_MAX_LEVEL * sizeof(skip_node_t *));
+    if (!list->head)
+        return -1;
+    list->head->height = SKIPLIST_MAX_LEVEL;
+    list->head->fully_linked = 1;
+    return 0;
+}
+
+void SkipList_destroy(SkipList_t *list)
+{
+    skip_node_t *cur, *next;
+    if (!list->head)
+        return;
+    for (cur = list->head->next[0]; cur; cur = next)
+    {
+        next = cur->next[0];
+        free(cur);
+    }
+    free(list->head);
+    list->head = NULL;
+}
+
+void SkipList_insert(SkipList_t *list, SortedListElement_t *element)
+{
+    skip_node_t *preds[SKIPLIST_MAX_LEVEL], *succs[SKIPLIST_MAX_LEVEL];
+    int height = random_height(), level;
+    if (!list || !element)
+        return;
+
+    epoch_enter();
+    for (;;)
+    {
+        find(list, element->key, preds, succs);
+
+        if (opt_yield & INSERT_YIELD)
+            sched_yield();
+
+        // Lock predecessors bottom-up and check they still fit
+        int highest = -1, valid = 1;
+        skip_node_t *prev = NULL;
+        for (level = 0; valid && level < height; ++level)
+        {
+            skip_node_t *pred = preds[level], *succ = succs[level];
+            if (pred != prev)
+            {
+                spin_acquire(&pred->lock);
+                highest = level;
+                prev = pred;
+            }
+            valid = !pred->marked && (!succ || !succ->marked) && load_next(pred, level) == succ;
+        }
+        if (!valid)
+        {
+            unlock_preds(preds, highest);
+            continue;
+        }
+
+        skip_node_t *node = node_alloc(element, height);
+        for (level = 0; level < height; ++level)
+            node->next[level] = succs[level];
+        for (level = 0; level < height; ++level)
+            __atomic_store_n(&preds[level]->next[level], node, __ATOMIC_RELEASE);
+        __atomic_store_n(&node->fully_linked, 1, __ATOMIC_RELEASE);
+        unlock_preds(preds, highest);
+        break;
+    }
+    epoch_exit();
+}
+
+int SkipList_delete(SkipList_t *list, SortedListElement_t *element)
+{
+    skip_node_t *preds[SKIPLIST_MAX_LEVEL], *succs[SKIPLIST_MAX_LEVEL];
+    skip_node_t *victim = NULL;
+    int is_marked = 0, height = 0, level;
+    if (!list || !element)
+        return 1;
+
+    epoch_enter();
+    for (;;)
+    {
+        int found = find(list, element->key, preds, succs);
+        if (found != -1)
+            victim = succs[found];
+        if (!is_marked &&
+            (found == -1 || !__atomic_load_n(&victim->fully_linked, __ATOMIC_ACQUIRE) ||
+             victim->height - 1 != found || victim->marked))
+        {
+            epoch_exit();
+            return 1;
+        }
+
+        if (!is_marked)
+        {
+            // Claim the victim: whoever marks it does the unlinking
+            height = victim->height;
+            spin_acquire(&victim->lock);
+            if (victim->marked)
+            {
+                spin_release(&victim->lock);
+                epoch_exit();
+                return 1;
+            }
+            __atomic_store_n(&victim->marked, 1, __ATOMIC_RELEASE);
+            is_marked = 1;
+        }
+
+        if (opt_yield & DELETE_YIELD)
+            sched_yield();
+
+        int highest = -1, valid = 1;
+        skip_node_t *prev = NULL;
+        for (level = 0; valid && level < height; ++level)
+        {
+            skip_node_t *pred = preds[level];
+            if (pred != prev)
+            {
+                spin_acquire(&pred->lock);
+                highest = level;
+                prev = pred;
+            }
+            valid = !pred->marked && load_next(pred, level) == victim;
+        }
+        if (!valid)
+        {
+            unlock_preds(preds, highest);
+            continue;
+        }
+
+        for (level = height - 1; level >= 0; --level)
+            __atomic_store_n(&preds[level]->next[level], victim->next[level], __ATOMIC_RELEASE);
+        spin_release(&victim->lock);
+        unlock_preds(preds, highest);
+        epoch_retire(victim, free);
+        epoch_exit();
+        return 0;
+    }
+}
+
+SortedListElement_t *SkipList_lookup(SkipList_t *list, const char *key)
+{
+    skip_node_t *preds[SKIPLIST_MAX_LEVEL], *succs[SKIPLIST_MAX_LEVEL];
+    SortedListElement_t *element = NULL;
+    if (!list || !key)
+        return NULL;
+
+    epoch_enter();
+    int found = find(list, key, preds, succs);
+    if (found != -1 && __atomic_load_n(&succs[found]->fully_linked, __ATOMIC_ACQUIRE) &&
+        !__atomic_load_n(&succs[found]->marked, __ATOMIC_ACQUIRE))
+        element = succs[found]->element;
+    epoch_exit();
+    return element;
+}
+
+int SkipList_length(SkipList_t *list)
+{
+    int length = 0;
+    if (!list)
+        return -1;
+
+    epoch_enter();
+    skip_node_t *cur = load_next(list->head, 0);
+    while (cur)
+    {
+        if (!__atomic_load_n(&cur->marked, __ATOMIC_ACQUIRE))
+            ++length;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        cur = load_next(cur, 0);
+    }
+    epoch_exit();
+    return length;
+}
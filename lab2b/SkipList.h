@@ -0,0 +1,70 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#include "SortedListExt.h"
+
+#define SKIPLIST_MAX_LEVEL 24
+
+/**
+ * SkipList
+ *
+ *	A concurrent skip list of SortedListElement_t with the same
+ *	operations as SortedList, in O(log n) expected time instead of
+ *	a list walk. It is the optimistic ("lazy") skip list of Herlihy,
+ *	Lev, Luchangco and Shavit: searches take no locks, and insert and
+ *	delete lock only the predecessors they relink, after validating
+ *	that nothing changed. Lookup and length never lock.
+ *
+ *	Each inserted element gets a separately allocated tower node.
+ *	Removed towers are freed through epoch-based reclamation (see
+ *	epoch.h), since searches may still be walking over them.
+ *
+ *	Elements are ordered by key with strcmp, and elements with equal
+ *	keys by the address of their key, so every element has a unique
+ *	position and lookups by key pointer are exact.
+ */
+struct skip_node;
+
+typedef struct SkipList
+{
+    struct skip_node *head;
+} SkipList_t;
+
+/**
+ * SkipList_init ... initialize an empty skip list
+ *
+ * @return 0 on success, -1 if the head could not be allocated
+ */
+int SkipList_init(SkipList_t *list);
+
+/**
+ * SkipList_destroy ... free the towers of an empty, unused skip list
+ */
+void SkipList_destroy(SkipList_t *list);
+
+void SkipList_insert(SkipList_t *list, SortedListElement_t *element);
+
+/**
+ * SkipList_delete ... remove an element from a skip list
+ *
+ * @return 0: element deleted, 1: element not found or already deleted
+ */
+int SkipList_delete(SkipList_t *list, SortedListElement_t *element);
+
+/**
+ * SkipList_lookup ... find the element whose key is this exact pointer
+ *
+ * @return pointer to matching element, or NULL if none is found
+ */
+SortedListElement_t *SkipList_lookup(SkipList_t *list, const char *key);
+
+/**
+ * SkipList_length ... count elements in a skip list
+ */
+int SkipList_length(SkipList_t *list);
+
+#endif
@@ -22,7 +22,7 @@ void SortedList_insert(SortedList_t *list, SortedListElement_t *element)
     }
 
     SortedList_t *cur = list->next;
-    while (cur != list && *(element->key) > *(cur->key))
+    while (cur != list && strcmp(element->key, cur->key) > 0)
         cur = cur->next;
 
     if (opt_yield & INSERT_YIELD)
@@ -0,0 +1,80 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "SortedListExt.h"
+#include <string.h>
+#include <sched.h>
+#include <stdlib.h>
+
+static int element_cmp(const void *a, const void *b)
+{
+    return strcmp((*(SortedListElement_t *const *)a)->key, (*(SortedListElement_t *const *)b)->key);
+}
+
+void SortedList_insert_batch(SortedList_t *list, SortedListElement_t **elements, int n)
+{
+    int i;
+    if (!list || !elements)
+        return;
+
+    for (i = 1; i < n && strcmp(elements[i - 1]->key, elements[i]->key) <= 0; ++i)
+        ;
+    if (i < n)
+        qsort(elements, n, sizeof(SortedListElement_t *), element_cmp);
+
+    if (!list->next)
+    {
+        if (opt_yield & INSERT_YIELD)
+            sched_yield();
+        list->next = list;
+        list->prev = list;
+        list->key = NULL;
+    }
+
+    // Each element goes in at or after the previous one, so the walk never restarts
+    SortedList_t *cur = list->next;
+    for (i = 0; i < n; ++i)
+    {
+        SortedListElement_t *element = elements[i];
+        while (cur != list && strcmp(element->key, cur->key) > 0)
+            cur = cur->next;
+
+        if (opt_yield & INSERT_YIELD)
+            sched_yield();
+
+        cur->prev->next = element;
+        element->prev = cur->prev;
+        element->next = cur;
+        cur->prev = element;
+    }
+}
+
+int SortedList_delete_batch(SortedListElement_t **elements, int n)
+{
+    int i, ret = 0;
+    if (!elements)
+        return 1;
+    for (i = 0; i < n; ++i)
+        ret |= SortedList_delete(elements[i]);
+    return ret;
+}
+
+int SortedList_verify(SortedList_t *list)
+{
+    if (!list || !list->next || list->next->prev != list)
+        return -1;
+    int length = 0;
+    SortedList_t *cur = list->next;
+    while (cur != list)
+    {
+        if (!cur->next || cur->next->prev != cur || cur->prev->next != cur ||
+            (cur->prev != list && strcmp(cur->prev->key, cur->key) > 0))
+            return -1;
+        ++length;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        cur = cur->next;
+    }
+    return length;
+}
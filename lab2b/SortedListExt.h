@@ -0,0 +1,76 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef SORTEDLISTEXT_H
+#define SORTEDLISTEXT_H
+
+/* SortedList.h is the assignment's fixed interface and has no include
+ * guard, so everything else includes it through this header */
+#include "SortedList.h"
+
+/**
+ * LockedListElement
+ *
+ *	A list element (or list head) with the per-element lock and
+ *	deleted mark that FineList and LazyList need. It begins with a
+ *	SortedListElement_t, so a pointer to one is a pointer to the
+ *	other and the lists link elements through the usual next
+ *	pointers. Plain SortedList elements stay three pointers wide.
+ */
+typedef struct LockedListElement
+{
+    SortedListElement_t element;
+    volatile int lock;   /* element lock, see spin_acquire in lock.h */
+    volatile int marked; /* logically deleted (LazyList) */
+} LockedListElement_t;
+
+/**
+ * locked_element ... the LockedListElement_t an element or head begins
+ */
+static inline LockedListElement_t *locked_element(SortedListElement_t *element)
+{
+    return (LockedListElement_t *)element;
+}
+
+/**
+ * SortedList_insert_batch ... insert several elements in one pass
+ *
+ *	The elements are sorted by key (in place, unless they already
+ *	are), then merged into the list in a single walk: each element
+ *	is linked in where the previous one left off, instead of every
+ *	insert walking from the head.
+ *
+ * @param SortedList_t *list ... header for the list
+ * @param SortedListElement_t **elements ... elements to be added
+ * @param int n ... number of elements
+ */
+void SortedList_insert_batch(SortedList_t *list, SortedListElement_t **elements, int n);
+
+/**
+ * SortedList_delete_batch ... remove several elements
+ *
+ *	Each element is checked and removed as by SortedList_delete;
+ *	the list is doubly linked, so no walk is needed.
+ *
+ * @param SortedListElement_t **elements ... elements to be removed
+ * @param int n ... number of elements
+ *
+ * @return 0: all deleted successfully, 1: some had corrupted prev/next pointers
+ */
+int SortedList_delete_batch(SortedListElement_t **elements, int n);
+
+/**
+ * SortedList_verify ... count elements, checking the whole list
+ *
+ *	Like SortedList_length, but checks every element's prev/next
+ *	pointers against its neighbours' and that the keys are in order.
+ *
+ * @param SortedList_t *list ... header for the list
+ *
+ * @return int number of elements in list (excluding head)
+ *	   -1 if the list is corrupted
+ */
+int SortedList_verify(SortedList_t *list);
+
+#endif
@@ -0,0 +1,214 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "UnrolledList.h"
+#include "keysearch.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE 64
+
+typedef struct unrolled_node
+{
+    struct unrolled_node *next;
+    int count;
+    uint64_t prefix[UNROLLED_CAPACITY];               /* key_prefix of each element's key */
+    SortedListElement_t *elements[UNROLLED_CAPACITY]; /* sorted by key */
+} __attribute__((aligned(CACHE_LINE))) unrolled_node_t;
+
+static unrolled_node_t *node_alloc(void)
+{
+    unrolled_node_t *node = aligned_alloc(CACHE_LINE, sizeof(unrolled_node_t));
+    if (!node)
+        abort();
+    node->next = NULL;
+    node->count = 0;
+    return node;
+}
+
+/* Move n elements and their prefixes from src[src_idx] to dst[dst_idx] */
+static void move_entries(unrolled_node_t *dst, int dst_idx, unrolled_node_t *src, int src_idx, int n)
+{
+    memmove(&dst->prefix[dst_idx], &src->prefix[src_idx], n * sizeof(uint64_t));
+    memmove(&dst->elements[dst_idx], &src->elements[src_idx], n * sizeof(SortedListElement_t *));
+}
+
+/* Compare element i of node with key, reading the key only if the prefixes tie */
+static int entry_cmp(unrolled_node_t *node, int i, const char *key, uint64_t prefix)
+{
+    if (node->prefix[i] != prefix)
+        return node->prefix[i] < prefix ? -1 : 1;
+    return strcmp(node->elements[i]->key, key);
+}
+
+/**
+ * Index of the first element of node whose key is greater than key
+ * (upper) or not less than it (!upper). The vector prefix search
+ * narrows it down to the elements sharing key's prefix, and only
+ * those are compared with strcmp.
+ */
+static int bound(unrolled_node_t *node, const char *key, uint64_t prefix, int upper)
+{
+    int equal;
+    int lo = prefix_rank(node->prefix, node->count, prefix, &equal), hi = lo + equal;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(node->elements[mid]->key, key);
+        if (upper ? cmp <= 0 : cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * Find target, or if it is NULL the element whose key is this exact
+ * pointer, among the elements whose keys compare equal to key. Sets
+ * *pidx to its index and *pprev to the node before its node.
+ */
+static unrolled_node_t *find(UnrolledList_t *list, const char *key, SortedListElement_t *target, int *pidx,
+                             unrolled_node_t **pprev)
+{
+    unrolled_node_t *prev = NULL, *node = list->head;
+    uint64_t prefix = key_prefix(key);
+    int i;
+    // Whole nodes below key are skipped on their last key alone
+    while (node && entry_cmp(node, node->count - 1, key, prefix) < 0)
+    {
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+        prev = node;
+        node = node->next;
+    }
+    // Equal keys may continue into the following nodes
+    for (i = node ? bound(node, key, prefix, 0) : 0; node; prev = node, node = node->next, i = 0)
+    {
+        for (; i < node->count; ++i)
+        {
+            SortedListElement_t *element = node->elements[i];
+            if (target ? element == target : element->key == key)
+            {
+                *pidx = i;
+                *pprev = prev;
+                return node;
+            }
+            if (entry_cmp(node, i, key, prefix) > 0)
+                return NULL;
+        }
+    }
+    return NULL;
+}
+
+void UnrolledList_insert(UnrolledList_t *list, SortedListElement_t *element)
+{
+    if (!list || !element)
+        return;
+
+    unrolled_node_t *node = list->head;
+    if (!node)
+    {
+        if (opt_yield & INSERT_YIELD)
+            sched_yield();
+        node = list->head = node_alloc();
+    }
+    uint64_t prefix = key_prefix(element->key);
+    while (node->next && entry_cmp(node, node->count - 1, element->key, prefix) <= 0)
+        node = node->next;
+    int pos = bound(node, element->key, prefix, 1);
+
+    if (opt_yield & INSERT_YIELD)
+        sched_yield();
+
+    if (node->count == UNROLLED_CAPACITY)
+    {
+        // Split: the upper half moves to a new node after this one
+        unrolled_node_t *split = node_alloc();
+        int half = UNROLLED_CAPACITY / 2;
+        split->count = node->count - half;
+        move_entries(split, 0, node, half, split->count);
+        node->count = half;
+        split->next = node->next;
+        node->next = split;
+        if (pos > half)
+        {
+            node = split;
+            pos -= half;
+        }
+    }
+    move_entries(node, pos + 1, node, pos, node->count - pos);
+    node->prefix[pos] = prefix;
+    node->elements[pos] = element;
+    ++node->count;
+}
+
+int UnrolledList_delete(UnrolledList_t *list, SortedListElement_t *element)
+{
+    unrolled_node_t *node, *prev;
+    int i;
+    if (!list || !element || !(node = find(list, element->key, element, &i, &prev)))
+        return 1;
+
+    if (opt_yield & DELETE_YIELD)
+        sched_yield();
+
+    move_entries(node, i, node, i + 1, node->count - i - 1);
+    --node->count;
+
+    unrolled_node_t *next = node->next;
+    if (0 == node->count)
+    {
+        if (prev)
+            prev->next = next;
+        else
+            list->head = next;
+        free(node);
+    }
+    else if (next && node->count < UNROLLED_CAPACITY / 2 && node->count + next->count <= UNROLLED_CAPACITY)
+    {
+        // Underflow: absorb the successor
+        move_entries(node, node->count, next, 0, next->count);
+        node->count += next->count;
+        node->next = next->next;
+        free(next);
+    }
+    return 0;
+}
+
+SortedListElement_t *UnrolledList_lookup(UnrolledList_t *list, const char *key)
+{
+    unrolled_node_t *node, *prev;
+    int i;
+    if (!list || !key || !(node = find(list, key, NULL, &i, &prev)))
+        return NULL;
+    return node->elements[i];
+}
+
+int UnrolledList_length(UnrolledList_t *list)
+{
+    unrolled_node_t *node;
+    int length = 0;
+    if (!list)
+        return -1;
+    for (node = list->head; node; node = node->next)
+    {
+        length += node->count;
+        if (opt_yield & LOOKUP_YIELD)
+            sched_yield();
+    }
+    return length;
+}
+
+void UnrolledList_destroy(UnrolledList_t *list)
+{
+    unrolled_node_t *node, *next;
+    for (node = list->head; node; node = next)
+    {
+        next = node->next;
+        free(node);
+    }
+    list->head = NULL;
+}
@@ -0,0 +1,71 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef UNROLLEDLIST_H
+#define UNROLLEDLIST_H
+
+#include "SortedListExt.h"
+
+/* Elements per node: with their key prefixes and the node header, four cache lines */
+#define UNROLLED_CAPACITY 15
+
+struct unrolled_node;
+
+/**
+ * UnrolledList
+ *
+ *	A sorted list whose nodes each hold a small sorted array of up to
+ *	UNROLLED_CAPACITY element pointers, so a search steps over a whole
+ *	node by comparing against its last key and only then searches
+ *	inside one node, instead of chasing a pointer per element.
+ *
+ *	Each node also caches the first 8 bytes of every key (see
+ *	keysearch.h), so searching a node is one vectorized pass over
+ *	its prefixes, and keys are only dereferenced and compared with
+ *	strcmp when their prefix ties with the one searched for.
+ *
+ *	A full node splits in two on insert. When a delete leaves a node
+ *	with room for its successor's elements, the two are merged, and
+ *	empty nodes are freed, so nodes stay at least half full on
+ *	average. Keys are compared with strcmp.
+ *
+ *	Like SortedList it does no synchronization of its own; callers
+ *	hold a lock around every operation. A zeroed UnrolledList_t is a
+ *	valid empty list.
+ */
+typedef struct UnrolledList
+{
+    struct unrolled_node *head;
+} UnrolledList_t;
+
+/**
+ * UnrolledList_insert ... insert an element, keeping the list sorted
+ */
+void UnrolledList_insert(UnrolledList_t *list, SortedListElement_t *element);
+
+/**
+ * UnrolledList_delete ... remove an element from a list
+ *
+ * @return 0: element deleted, 1: element not found in the list
+ */
+int UnrolledList_delete(UnrolledList_t *list, SortedListElement_t *element);
+
+/**
+ * UnrolledList_lookup ... find the element whose key is this exact pointer
+ *
+ * @return pointer to matching element, or NULL if none is found
+ */
+SortedListElement_t *UnrolledList_lookup(UnrolledList_t *list, const char *key);
+
+/**
+ * UnrolledList_length ... count elements in a list, one node at a time
+ */
+int UnrolledList_length(UnrolledList_t *list);
+
+/**
+ * UnrolledList_destroy ... free the nodes of a list, not its elements
+ */
+void UnrolledList_destroy(UnrolledList_t *list);
+
+#endif
@@ -0,0 +1,274 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#define _GNU_SOURCE
+#include "affinity.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct cpu_info
+{
+    int cpu;
+    int package;
+    int core;
+    int sibling;   /* index among the hyperthreads of its core */
+    int core_rank; /* index of its core within its package */
+};
+
+static int *cpu_order = NULL; /* thread i runs on cpu_order[i % ncpus] */
+static int ncpus = 0;
+
+static int read_topology(int cpu, const char *name)
+{
+    char path[128];
+    int val = -1;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+    if (1 != fscanf(f, "%d", &val))
+        val = -1;
+    fclose(f);
+    return val;
+}
+
+static int cmp_compact(const void *a, const void *b)
+{
+    const struct cpu_info *x = a, *y = b;
+    if (x->package != y->package)
+        return x->package - y->package;
+    if (x->core != y->core)
+        return x->core - y->core;
+    return x->cpu - y->cpu;
+}
+
+/* Allowed CPUs sorted by (package, core, cpu) */
+static int get_cpus(struct cpu_info **out)
+{
+    cpu_set_t set;
+    int cpu, n = 0;
+    if (0 != sched_getaffinity(0, sizeof(set), &set))
+        return -1;
+    struct cpu_info *info = malloc(CPU_COUNT(&set) * sizeof(struct cpu_info));
+    if (!info)
+        return -1;
+    for (cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (!CPU_ISSET(cpu, &set))
+            continue;
+        info[n].cpu = cpu;
+        info[n].package = read_topology(cpu, "physical_package_id");
+        info[n].core = read_topology(cpu, "core_id");
+        if (info[n].core < 0)
+            info[n].core = cpu;
+        info[n].sibling = 0;
+        info[n].core_rank = 0;
+        ++n;
+    }
+    qsort(info, n, sizeof(struct cpu_info), cmp_compact);
+    *out = info;
+    return n;
+}
+
+static int order_compact(void)
+{
+    struct cpu_info *info;
+    int i, n = get_cpus(&info);
+    if (n <= 0)
+        return -1;
+    cpu_order = malloc(n * sizeof(int));
+    if (!cpu_order)
+    {
+        free(info);
+        return -1;
+    }
+    for (i = 0; i < n; ++i)
+        cpu_order[i] = info[i].cpu;
+    ncpus = n;
+    free(info);
+    return 0;
+}
+
+static int cmp_scatter(const void *a, const void *b)
+{
+    const struct cpu_info *x = a, *y = b;
+    if (x->sibling != y->sibling)
+        return x->sibling - y->sibling;
+    if (x->core_rank != y->core_rank)
+        return x->core_rank - y->core_rank;
+    return x->package - y->package;
+}
+
+/* Round-robin across packages one core at a time, so hyperthread
+ * siblings are only used once every core has a thread */
+static int order_scatter(void)
+{
+    struct cpu_info *info;
+    int i, n = get_cpus(&info);
+    if (n <= 0)
+        return -1;
+    for (i = 0; i < n; ++i)
+    {
+        if (i > 0 && info[i].package == info[i - 1].package && info[i].core == info[i - 1].core)
+        {
+            info[i].sibling = info[i - 1].sibling + 1;
+            info[i].core_rank = info[i - 1].core_rank;
+        }
+        else if (i > 0 && info[i].package == info[i - 1].package)
+            info[i].core_rank = info[i - 1].core_rank + 1;
+    }
+    qsort(info, n, sizeof(struct cpu_info), cmp_scatter);
+    cpu_order = malloc(n * sizeof(int));
+    if (!cpu_order)
+    {
+        free(info);
+        return -1;
+    }
+    for (i = 0; i < n; ++i)
+        cpu_order[i] = info[i].cpu;
+    ncpus = n;
+    free(info);
+    return 0;
+}
+
+static int order_list(const char *spec)
+{
+    int cap = 16;
+    const char *p = spec;
+    cpu_order = malloc(cap * sizeof(int));
+    ncpus = 0;
+    if (!cpu_order)
+        return -1;
+    while (*p)
+    {
+        char *end;
+        long lo = strtol(p, &end, 10), hi;
+        if (end == p || lo < 0 || lo >= CPU_SETSIZE)
+            return -1;
+        hi = lo;
+        p = end;
+        if (*p == '-')
+        {
+            hi = strtol(p + 1, &end, 10);
+            if (end == p + 1 || hi < lo || hi >= CPU_SETSIZE)
+                return -1;
+            p = end;
+        }
+        for (; lo <= hi; ++lo)
+        {
+            if (ncpus == cap)
+            {
+                // On failure cpu_order is left for affinity_cleanup to free
+                int *grown = realloc(cpu_order, 2 * cap * sizeof(int));
+                if (!grown)
+                    return -1;
+                cpu_order = grown;
+                cap *= 2;
+            }
+            cpu_order[ncpus++] = (int)lo;
+        }
+        if (*p == ',')
+            ++p;
+        else if (*p)
+            return -1;
+    }
+    return ncpus > 0 ? 0 : -1;
+}
+
+int affinity_init(const char *spec)
+{
+    int ret;
+    affinity_cleanup();
+    if (0 == strcmp(spec, "compact"))
+        ret = order_compact();
+    else if (0 == strcmp(spec, "scatter"))
+        ret = order_scatter();
+    else
+        ret = order_list(spec);
+    if (0 != ret)
+        affinity_cleanup();
+    return ret;
+}
+
+int affinity_enabled(void)
+{
+    return ncpus > 0;
+}
+
+int affinity_cpu(int thread_idx)
+{
+    if (ncpus == 0)
+        return -1;
+    return cpu_order[thread_idx % ncpus];
+}
+
+int affinity_pin_self(int thread_idx)
+{
+    cpu_set_t set;
+    int cpu = affinity_cpu(thread_idx);
+    if (cpu < 0)
+        return 0;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+struct touch_arg
+{
+    char *base;
+    size_t size;
+    int thread_idx;
+    int err;
+};
+
+static void *touch_slice(void *arg)
+{
+    struct touch_arg *t = arg;
+    t->err = affinity_pin_self(t->thread_idx);
+    memset(t->base, 0, t->size);
+    return NULL;
+}
+
+int affinity_first_touch(void *base, size_t slice_size, int nthreads)
+{
+    int i, err = 0;
+    pthread_t *tids = malloc(nthreads * sizeof(pthread_t));
+    struct touch_arg *args = malloc(nthreads * sizeof(struct touch_arg));
+    if (!tids || !args)
+    {
+        free(tids);
+        free(args);
+        return ENOMEM;
+    }
+    for (i = 0; i < nthreads; ++i)
+    {
+        args[i].base = (char *)base + i * slice_size;
+        args[i].size = slice_size;
+        args[i].thread_idx = i;
+        args[i].err = 0;
+        if (0 != (err = pthread_create(&tids[i], NULL, touch_slice, &args[i])))
+            break;
+    }
+    nthreads = i;
+    for (i = 0; i < nthreads; ++i)
+    {
+        pthread_join(tids[i], NULL);
+        if (!err)
+            err = args[i].err;
+    }
+    free(tids);
+    free(args);
+    return err;
+}
+
+void affinity_cleanup(void)
+{
+    free(cpu_order);
+    cpu_order = NULL;
+    ncpus = 0;
+}
@@ -0,0 +1,60 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <stddef.h>
+
+/**
+ * affinity_init ... choose where benchmark threads run
+ *
+ *	compact  fill one socket (and each core's hyperthreads) before
+ *	         moving on to the next
+ *	scatter  round-robin threads across sockets, one core at a time
+ *	<list>   an explicit CPU list such as "0,2,8-11"
+ *
+ *	Thread i runs on the i-th CPU of the resulting order, wrapping
+ *	around when there are more threads than CPUs. Only CPUs in the
+ *	process's affinity mask are used.
+ *
+ * @param const char *spec ... value of the --pin flag
+ *
+ * @return 0 on success, -1 if the spec is invalid
+ */
+int affinity_init(const char *spec);
+
+/**
+ * affinity_enabled ... whether affinity_init has been called successfully
+ */
+int affinity_enabled(void);
+
+/**
+ * affinity_cpu ... CPU assigned to a thread index, or -1 if not pinning
+ */
+int affinity_cpu(int thread_idx);
+
+/**
+ * affinity_pin_self ... pin the calling thread to its assigned CPU
+ *
+ * @return 0 on success (or when not pinning), an errno value on failure
+ */
+int affinity_pin_self(int thread_idx);
+
+/**
+ * affinity_first_touch ... fault in per-thread slices on their threads' nodes
+ *
+ *	Splits [base, base + nthreads * slice_size) into nthreads slices
+ *	and zeroes slice i from a helper thread pinned like thread i.
+ *	Under the default first-touch policy each page is then backed by
+ *	memory on the NUMA node of the CPU that will use it. The memory
+ *	must not have been written before this call.
+ *
+ * @return 0 on success, an errno value on failure
+ */
+int affinity_first_touch(void *base, size_t slice_size, int nthreads);
+
+void affinity_cleanup(void);
+
+#endif
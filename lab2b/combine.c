@@ -0,0 +1,131 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "combine.h"
+#include "lock.h"
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE 64
+
+enum slot_state
+{
+    SLOT_IDLE,
+    SLOT_PENDING, /* posted, waiting for a combiner or the server */
+    SLOT_DONE     /* result is ready */
+};
+
+struct combine_slot
+{
+    volatile int state;
+    int op;
+    void *target;
+    void *arg;
+    intptr_t result;
+} __attribute__((aligned(CACHE_LINE)));
+
+/* One scan of the publication array; the caller holds the lock or is the server */
+static int combine(combiner_t *comb)
+{
+    int i, ran = 0;
+    for (i = 0; i < comb->nslots; ++i)
+    {
+        struct combine_slot *slot = &comb->slots[i];
+        if (SLOT_PENDING != __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE))
+            continue;
+        slot->result = comb->apply(slot->op, slot->target, slot->arg);
+        if (!ran++)
+            ++comb->passes;
+        ++comb->combined;
+        __atomic_store_n(&slot->state, SLOT_DONE, __ATOMIC_RELEASE);
+    }
+    return ran;
+}
+
+/* Spin a while, then give the CPU to whoever holds the combiner or the server */
+static void relax(int *spins)
+{
+    if (++*spins < lock_spin_limit)
+        cpu_relax();
+    else
+    {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+static void *serve(void *arg)
+{
+    combiner_t *comb = arg;
+    int spins = 0;
+    if (comb->server_init)
+        comb->server_init();
+    while (!__atomic_load_n(&comb->stop, __ATOMIC_ACQUIRE))
+    {
+        if (combine(comb))
+            spins = 0;
+        else
+            relax(&spins);
+    }
+    return NULL;
+}
+
+int combiner_init(combiner_t *comb, int nslots, intptr_t (*apply)(int op, void *target, void *arg))
+{
+    memset(comb, 0, sizeof(combiner_t));
+    comb->slots = aligned_alloc(CACHE_LINE, nslots * sizeof(struct combine_slot));
+    if (!comb->slots)
+        return ENOMEM;
+    memset(comb->slots, 0, nslots * sizeof(struct combine_slot));
+    comb->nslots = nslots;
+    comb->apply = apply;
+    return 0;
+}
+
+intptr_t combiner_execute(combiner_t *comb, int slot_idx, int op, void *target, void *arg)
+{
+    struct combine_slot *slot = &comb->slots[slot_idx];
+    int spins = 0;
+    slot->op = op;
+    slot->target = target;
+    slot->arg = arg;
+    __atomic_store_n(&slot->state, SLOT_PENDING, __ATOMIC_RELEASE);
+    while (SLOT_DONE != __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE))
+    {
+        // Become the combiner if nobody is; our own request is then done by the time we let go
+        if (!comb->serving && !comb->lock && !__sync_lock_test_and_set(&comb->lock, 1))
+        {
+            combine(comb);
+            __sync_lock_release(&comb->lock);
+        }
+        else
+            relax(&spins);
+    }
+    intptr_t result = slot->result;
+    slot->state = SLOT_IDLE;
+    return result;
+}
+
+int combiner_serve(combiner_t *comb, void (*init)(void))
+{
+    comb->server_init = init;
+    int err = pthread_create(&comb->server, NULL, serve, comb);
+    if (0 == err)
+        comb->serving = 1;
+    return err;
+}
+
+void combiner_destroy(combiner_t *comb)
+{
+    if (comb->serving)
+    {
+        __atomic_store_n(&comb->stop, 1, __ATOMIC_RELEASE);
+        pthread_join(comb->server, NULL);
+        comb->serving = 0;
+    }
+    free(comb->slots);
+    comb->slots = NULL;
+}
@@ -0,0 +1,82 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef COMBINE_H
+#define COMBINE_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+struct combine_slot;
+
+/**
+ * combiner_t
+ *
+ *	Runs operations on a shared structure from one thread at a time,
+ *	without every thread taking a lock and pulling the structure into
+ *	its own cache. A thread posts its operation in its own slot of a
+ *	publication array and waits for the result.
+ *
+ *	Flat combining: whichever waiting thread gets the combiner lock
+ *	scans the array and runs every pending operation, its own among
+ *	them, in one pass; the others just see their results appear.
+ *
+ *	Delegation (after combiner_serve): a dedicated server thread does
+ *	all the scanning, and posting threads never run operations.
+ *
+ *	Either way operations run one at a time, through the apply
+ *	callback given to combiner_init, so the structure needs no
+ *	synchronization of its own. Waiting threads spin, then yield.
+ *
+ *	passes and combined are counted before each result is released,
+ *	so they are exact once every posting thread has its results, and
+ *	may be zeroed whenever no operation is pending.
+ */
+typedef struct combiner
+{
+    volatile int lock;
+    int nslots;
+    struct combine_slot *slots; /* one per posting thread, one cache line each */
+    intptr_t (*apply)(int op, void *target, void *arg);
+    long long passes;   /* scans of the publication array that ran at least one operation */
+    long long combined; /* operations run */
+    void (*server_init)(void);
+    int serving;
+    volatile int stop;
+    pthread_t server;
+} __attribute__((aligned(64))) combiner_t;
+
+/**
+ * combiner_init ... set up a combiner for nslots posting threads
+ *
+ * @return 0, or ENOMEM
+ */
+int combiner_init(combiner_t *comb, int nslots, intptr_t (*apply)(int op, void *target, void *arg));
+
+/**
+ * combiner_execute ... run apply(op, target, arg) through the combiner
+ *
+ *	slot is the calling thread's own slot, in [0, nslots); no two
+ *	threads may use the same slot at once.
+ *
+ * @return what apply returned
+ */
+intptr_t combiner_execute(combiner_t *comb, int slot, int op, void *target, void *arg);
+
+/**
+ * combiner_serve ... start a server thread and delegate every operation to it
+ *
+ *	The server calls init first, if init is not NULL, e.g. to pin
+ *	itself.
+ *
+ * @return 0, or an errno value
+ */
+int combiner_serve(combiner_t *comb, void (*init)(void));
+
+/**
+ * combiner_destroy ... stop the server, if any, and free the slots
+ */
+void combiner_destroy(combiner_t *comb);
+
+#endif
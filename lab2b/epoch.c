@@ -0,0 +1,121 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "epoch.h"
+#include <stdlib.h>
+
+#define EPOCH_COLLECT_INTERVAL 64
+
+struct retired
+{
+    void *ptr;
+    void (*free_fn)(void *);
+    unsigned long epoch; /* global epoch when it was retired */
+};
+
+struct epoch_record
+{
+    /* (epoch << 1) | 1 while in a critical section, 0 otherwise */
+    volatile unsigned long state;
+    struct retired *limbo;
+    int nlimbo;
+    int cap;
+    struct epoch_record *next;
+};
+
+static volatile unsigned long global_epoch = 2;
+static struct epoch_record *volatile records = NULL;
+static __thread struct epoch_record *self = NULL;
+
+static struct epoch_record *epoch_register(void)
+{
+    struct epoch_record *rec = calloc(1, sizeof(struct epoch_record));
+    if (!rec)
+        abort();
+    rec->next = __atomic_load_n(&records, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&records, &rec->next, rec, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+    return rec;
+}
+
+void epoch_enter(void)
+{
+    if (!self)
+        self = epoch_register();
+    unsigned long e = __atomic_load_n(&global_epoch, __ATOMIC_RELAXED);
+    __atomic_store_n(&self->state, (e << 1) | 1, __ATOMIC_RELAXED);
+    /* Publish that we are pinned before reading any shared pointer */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void epoch_exit(void)
+{
+    __atomic_store_n(&self->state, 0, __ATOMIC_RELEASE);
+}
+
+/* Advance the global epoch if every pinned thread has seen it */
+static unsigned long epoch_try_advance(void)
+{
+    unsigned long e = __atomic_load_n(&global_epoch, __ATOMIC_RELAXED);
+    struct epoch_record *rec;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (rec = __atomic_load_n(&records, __ATOMIC_ACQUIRE); rec; rec = rec->next)
+    {
+        unsigned long state = __atomic_load_n(&rec->state, __ATOMIC_RELAXED);
+        if ((state & 1) && (state >> 1) != e)
+            return e;
+    }
+    if (__atomic_compare_exchange_n(&global_epoch, &e, e + 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        return e + 1;
+    return e;
+}
+
+/* Free everything retired at least two epochs ago */
+static void epoch_collect(struct epoch_record *rec, unsigned long e)
+{
+    int i, kept = 0;
+    for (i = 0; i < rec->nlimbo; ++i)
+    {
+        if (rec->limbo[i].epoch + 2 <= e)
+            rec->limbo[i].free_fn(rec->limbo[i].ptr);
+        else
+            rec->limbo[kept++] = rec->limbo[i];
+    }
+    rec->nlimbo = kept;
+}
+
+void epoch_retire(void *ptr, void (*free_fn)(void *))
+{
+    struct epoch_record *rec = self;
+    if (rec->nlimbo == rec->cap)
+    {
+        rec->cap = rec->cap ? 2 * rec->cap : EPOCH_COLLECT_INTERVAL;
+        rec->limbo = realloc(rec->limbo, rec->cap * sizeof(struct retired));
+        if (!rec->limbo)
+            abort();
+    }
+    rec->limbo[rec->nlimbo].ptr = ptr;
+    rec->limbo[rec->nlimbo].free_fn = free_fn;
+    rec->limbo[rec->nlimbo].epoch = __atomic_load_n(&global_epoch, __ATOMIC_RELAXED);
+    if (++rec->nlimbo % EPOCH_COLLECT_INTERVAL == 0)
+        epoch_collect(rec, epoch_try_advance());
+}
+
+void epoch_poll(void)
+{
+    if (self)
+        epoch_collect(self, epoch_try_advance());
+}
+
+void epoch_barrier(void)
+{
+    struct epoch_record *rec;
+    for (rec = __atomic_load_n(&records, __ATOMIC_ACQUIRE); rec; rec = rec->next)
+    {
+        int i;
+        for (i = 0; i < rec->nlimbo; ++i)
+            rec->limbo[i].free_fn(rec->limbo[i].ptr);
+        rec->nlimbo = 0;
+    }
+}
@@ -0,0 +1,48 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef EPOCH_H
+#define EPOCH_H
+
+/**
+ * Epoch-based memory reclamation
+ *
+ *	Readers of a lock-free structure bracket every operation with
+ *	epoch_enter and epoch_exit. A node that has been unlinked is
+ *	handed to epoch_retire instead of being freed; its free function
+ *	runs only once every thread that might still hold a reference
+ *	to it has left its critical section, i.e. after the global epoch
+ *	has advanced twice.
+ *
+ *	Critical sections must not nest. Each thread registers itself on
+ *	its first epoch_enter; its record (and anything it retired but
+ *	has not yet freed) outlives the thread until epoch_barrier.
+ */
+void epoch_enter(void);
+void epoch_exit(void);
+
+/**
+ * epoch_retire ... defer free_fn(ptr) until no reader can reach ptr
+ *
+ *	Must be called inside a critical section.
+ */
+void epoch_retire(void *ptr, void (*free_fn)(void *));
+
+/**
+ * epoch_poll ... try to advance the epoch and run the caller's due free functions
+ *
+ *	epoch_retire only does this every so many retires; a thread
+ *	waiting to reuse what it retired can poll sooner.
+ */
+void epoch_poll(void);
+
+/**
+ * epoch_barrier ... run every pending free function
+ *
+ *	Only safe when no thread is inside a critical section, e.g.
+ *	after all worker threads have been joined.
+ */
+void epoch_barrier(void);
+
+#endif
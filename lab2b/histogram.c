@@ -0,0 +1,66 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "histogram.h"
+
+static int bucket_of(unsigned long long value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS)
+        return value;
+    // The top HISTOGRAM_SUB_BITS bits below the leading one pick the sub-bucket
+    int shift = 63 - __builtin_clzll(value) - HISTOGRAM_SUB_BITS;
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + ((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/* Largest value that falls in a bucket */
+static unsigned long long bucket_top(int bucket)
+{
+    if (bucket < HISTOGRAM_SUB_BUCKETS)
+        return bucket;
+    int shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    unsigned long long base = (unsigned long long)(HISTOGRAM_SUB_BUCKETS + bucket % HISTOGRAM_SUB_BUCKETS) << shift;
+    return base + ((1ULL << shift) - 1);
+}
+
+void histogram_record(histogram_t *hist, long long value)
+{
+    if (value < 0)
+        value = 0;
+    ++hist->buckets[bucket_of(value)];
+    ++hist->count;
+    if (value > hist->max)
+        hist->max = value;
+}
+
+void histogram_merge(histogram_t *dst, const histogram_t *src)
+{
+    int i;
+    for (i = 0; i < HISTOGRAM_NBUCKETS; ++i)
+        dst->buckets[i] += src->buckets[i];
+    dst->count += src->count;
+    if (src->max > dst->max)
+        dst->max = src->max;
+}
+
+long long histogram_percentile(const histogram_t *hist, double percent)
+{
+    long long rank, seen = 0;
+    int i;
+    if (0 == hist->count)
+        return 0;
+    // The rank-th smallest value, counting from 1
+    rank = (long long)(percent / 100 * hist->count + 0.5);
+    if (rank < 1)
+        rank = 1;
+    for (i = 0; i < HISTOGRAM_NBUCKETS; ++i)
+    {
+        seen += hist->buckets[i];
+        if (seen >= rank)
+        {
+            unsigned long long top = bucket_top(i);
+            return top < (unsigned long long)hist->max ? (long long)top : hist->max;
+        }
+    }
+    return hist->max;
+}
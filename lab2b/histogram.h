@@ -0,0 +1,48 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+/**
+ * histogram_t
+ *
+ *	Log-linear histogram of non-negative latencies (ns): values below
+ *	HISTOGRAM_SUB_BUCKETS get a bucket each, and every power of two
+ *	above that is split into HISTOGRAM_SUB_BUCKETS equal buckets, so
+ *	any recorded value is known to within 1/16 (about 6%) across the
+ *	whole 64-bit range, in a fixed 8KB. Recording is a few shifts and
+ *	an increment; each thread records into its own histogram and they
+ *	are merged once the run is over. A zeroed histogram_t is empty.
+ */
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_NBUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct histogram
+{
+    long long count;
+    long long max;
+    long long buckets[HISTOGRAM_NBUCKETS];
+} histogram_t;
+
+/**
+ * histogram_record ... add one value; negative values count as 0
+ */
+void histogram_record(histogram_t *hist, long long value);
+
+/**
+ * histogram_merge ... add every value recorded in src to dst
+ */
+void histogram_merge(histogram_t *dst, const histogram_t *src);
+
+/**
+ * histogram_percentile ... value at or below which percent of the values lie
+ *
+ * @return upper bound of the bucket holding that value, capped at the
+ *	   largest value recorded, or 0 for an empty histogram
+ */
+long long histogram_percentile(const histogram_t *hist, double percent);
+
+#endif
@@ -0,0 +1,143 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "keygen.h"
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KEY_CHAR_MIN 32  /* space */
+#define KEY_CHAR_RANGE 94 /* up to but not including ~, as the original keys */
+
+/* Indexed by enum keygen_dist */
+static const char *dist_names[] = {"uniform", "zipf", "sequential", "shuffled"};
+#define NDISTS (int)(sizeof(dist_names) / sizeof(dist_names[0]))
+
+/* Width of the zero-padded sequential keys */
+static int sequential_width(keygen_t *gen)
+{
+    int width = 1, n;
+    for (n = gen->nkeys - 1; n >= 10; n /= 10)
+        ++width;
+    return width > gen->min_len ? width : gen->min_len;
+}
+
+/* Deterministic key text for a Zipf rank, so every draw of a rank yields the same key */
+static int rank_key(keygen_t *gen, int rank, char *buf)
+{
+    uint64_t state = 0x9e3779b97f4a7c15ULL * (rank + 1);
+    int len, i;
+    state ^= state >> 31;
+    len = gen->min_len + state % (gen->max_len - gen->min_len + 1);
+    for (i = 0; i < len; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        buf[i] = KEY_CHAR_MIN + state % KEY_CHAR_RANGE;
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+static int zipf_rank(keygen_t *gen)
+{
+    double u = (double)rand() / RAND_MAX;
+    int lo = 0, hi = gen->nkeys - 1;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (gen->cdf[mid] < u)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+int keygen_init(keygen_t *gen, const char *dist, int nkeys, int min_len, int max_len)
+{
+    int i;
+    memset(gen, 0, sizeof(keygen_t));
+    if (nkeys < 0 || min_len < 1 || max_len < min_len)
+        return EINVAL;
+    for (i = 0; i < NDISTS; ++i)
+    {
+        if (0 == strcmp(dist, dist_names[i]))
+            break;
+    }
+    if (i == NDISTS)
+        return EINVAL;
+    gen->dist = i;
+    gen->nkeys = nkeys;
+    gen->min_len = min_len;
+    gen->max_len = max_len;
+
+    if (gen->dist == KEYGEN_ZIPF && nkeys > 0)
+    {
+        gen->cdf = malloc(nkeys * sizeof(double));
+        if (!gen->cdf)
+            return ENOMEM;
+        double sum = 0;
+        for (i = 0; i < nkeys; ++i)
+            gen->cdf[i] = sum += 1.0 / pow(i + 1, KEYGEN_ZIPF_S);
+        for (i = 0; i < nkeys; ++i)
+            gen->cdf[i] /= sum;
+    }
+    else if (gen->dist == KEYGEN_SHUFFLED && nkeys > 0)
+    {
+        // Fisher-Yates shuffle of the sequential order
+        gen->order = malloc(nkeys * sizeof(int));
+        if (!gen->order)
+            return ENOMEM;
+        for (i = 0; i < nkeys; ++i)
+            gen->order[i] = i;
+        for (i = nkeys - 1; i > 0; --i)
+        {
+            int j = rand() % (i + 1), tmp = gen->order[i];
+            gen->order[i] = gen->order[j];
+            gen->order[j] = tmp;
+        }
+    }
+    return 0;
+}
+
+int keygen_max_length(keygen_t *gen)
+{
+    if (gen->dist == KEYGEN_SEQUENTIAL || gen->dist == KEYGEN_SHUFFLED)
+        return sequential_width(gen);
+    return gen->max_len;
+}
+
+int keygen_key(keygen_t *gen, int idx, char *buf)
+{
+    int len, i;
+    switch (gen->dist)
+    {
+    case KEYGEN_ZIPF:
+        return rank_key(gen, zipf_rank(gen), buf);
+    case KEYGEN_SEQUENTIAL:
+        return sprintf(buf, "%0*d", sequential_width(gen), idx);
+    case KEYGEN_SHUFFLED:
+        return sprintf(buf, "%0*d", sequential_width(gen), gen->order[idx]);
+    default:
+        // Fixed-length keys draw no length, so length 1 reproduces the original keys
+        len = gen->min_len == gen->max_len ? gen->min_len : gen->min_len + rand() % (gen->max_len - gen->min_len + 1);
+        for (i = 0; i < len; ++i)
+            buf[i] = KEY_CHAR_MIN + rand() % KEY_CHAR_RANGE;
+        buf[len] = '\0';
+        return len;
+    }
+}
+
+void keygen_destroy(keygen_t *gen)
+{
+    free(gen->order);
+    free(gen->cdf);
+    gen->order = NULL;
+    gen->cdf = NULL;
+}
@@ -0,0 +1,72 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef KEYGEN_H
+#define KEYGEN_H
+
+/* Zipf exponent, as in YCSB */
+#define KEYGEN_ZIPF_S 0.99
+
+/**
+ * keygen_t
+ *
+ *	Generates the benchmark's keys, NUL-terminated and made of
+ *	printable characters, from one of these distributions:
+ *
+ *	  uniform     random characters, length uniform in [min, max]
+ *	  zipf        nkeys draws from a universe of nkeys distinct keys
+ *	              whose popularity follows Zipf's law, so hot keys
+ *	              repeat
+ *	  sequential  "000", "001", ... zero-padded to at least min
+ *	              characters, in ascending strcmp order
+ *	  shuffled    the sequential keys in random order
+ *
+ *	Random choices use rand(), so runs are repeatable.
+ */
+enum keygen_dist
+{
+    KEYGEN_UNIFORM,
+    KEYGEN_ZIPF,
+    KEYGEN_SEQUENTIAL,
+    KEYGEN_SHUFFLED
+};
+
+typedef struct keygen
+{
+    enum keygen_dist dist;
+    int nkeys;
+    int min_len;
+    int max_len;
+    int *order;  /* shuffled: permutation of 0 .. nkeys - 1 */
+    double *cdf; /* zipf: cumulative popularity of each rank */
+} keygen_t;
+
+/**
+ * keygen_init ... set up a generator for nkeys keys
+ *
+ * @param const char *dist ... uniform, zipf, sequential or shuffled
+ *
+ * @return 0 on success, EINVAL for a bad distribution or length,
+ *	ENOMEM if its tables could not be allocated
+ */
+int keygen_init(keygen_t *gen, const char *dist, int nkeys, int min_len, int max_len);
+
+/**
+ * keygen_max_length ... longest key the generator writes, without the NUL
+ */
+int keygen_max_length(keygen_t *gen);
+
+/**
+ * keygen_key ... write key number idx (0 .. nkeys - 1) into buf
+ *
+ *	Keys must be generated in order. buf needs room for
+ *	keygen_max_length + 1 characters.
+ *
+ * @return length of the key written, without the NUL
+ */
+int keygen_key(keygen_t *gen, int idx, char *buf);
+
+void keygen_destroy(keygen_t *gen);
+
+#endif
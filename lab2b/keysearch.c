@@ -0,0 +1,110 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "keysearch.h"
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KEYSEARCH_X86 1
+#endif
+
+uint64_t key_prefix(const char *key)
+{
+    uint64_t prefix = 0;
+    int i;
+    for (i = 0; i < 8; ++i)
+    {
+        prefix <<= 8;
+        if (*key)
+            prefix |= (unsigned char)*key++;
+    }
+    return prefix;
+}
+
+static int rank_scalar(const uint64_t *prefixes, int n, uint64_t probe, int *pequal)
+{
+    int i, less = 0, equal = 0;
+    for (i = 0; i < n; ++i)
+    {
+        less += prefixes[i] < probe;
+        equal += prefixes[i] == probe;
+    }
+    if (pequal)
+        *pequal = equal;
+    return less;
+}
+
+#ifdef KEYSEARCH_X86
+/* There is no unsigned 64-bit compare, so flip the sign bits and compare signed */
+#define SIGN_BIT INT64_MIN
+
+__attribute__((target("avx2"))) static int rank_avx2(const uint64_t *prefixes, int n, uint64_t probe, int *pequal)
+{
+    const __m256i sign = _mm256_set1_epi64x(SIGN_BIT);
+    const __m256i vprobe = _mm256_set1_epi64x((long long)probe);
+    const __m256i sprobe = _mm256_xor_si256(vprobe, sign);
+    int i, less = 0, equal = 0, tail_equal;
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(prefixes + i));
+        __m256i lt = _mm256_cmpgt_epi64(sprobe, _mm256_xor_si256(v, sign));
+        __m256i eq = _mm256_cmpeq_epi64(v, vprobe);
+        less += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(lt)));
+        equal += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+    }
+    less += rank_scalar(prefixes + i, n - i, probe, &tail_equal);
+    if (pequal)
+        *pequal = equal + tail_equal;
+    return less;
+}
+
+__attribute__((target("sse4.2"))) static int rank_sse42(const uint64_t *prefixes, int n, uint64_t probe, int *pequal)
+{
+    const __m128i sign = _mm_set1_epi64x(SIGN_BIT);
+    const __m128i vprobe = _mm_set1_epi64x((long long)probe);
+    const __m128i sprobe = _mm_xor_si128(vprobe, sign);
+    int i, less = 0, equal = 0, tail_equal;
+    for (i = 0; i + 2 <= n; i += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(prefixes + i));
+        __m128i lt = _mm_cmpgt_epi64(sprobe, _mm_xor_si128(v, sign));
+        __m128i eq = _mm_cmpeq_epi64(v, vprobe);
+        less += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(lt)));
+        equal += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(eq)));
+    }
+    less += rank_scalar(prefixes + i, n - i, probe, &tail_equal);
+    if (pequal)
+        *pequal = equal + tail_equal;
+    return less;
+}
+#endif
+
+typedef int (*rank_fn)(const uint64_t *, int, uint64_t, int *);
+
+/* Picked on first use; racing threads all store the same kernel */
+static rank_fn rank_kernel = NULL;
+
+static rank_fn choose_kernel(void)
+{
+#ifdef KEYSEARCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return rank_avx2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return rank_sse42;
+#endif
+    return rank_scalar;
+}
+
+int prefix_rank(const uint64_t *prefixes, int n, uint64_t probe, int *pequal)
+{
+    rank_fn kernel = __atomic_load_n(&rank_kernel, __ATOMIC_RELAXED);
+    if (!kernel)
+    {
+        kernel = choose_kernel();
+        __atomic_store_n(&rank_kernel, kernel, __ATOMIC_RELAXED);
+    }
+    return kernel(prefixes, n, probe, pequal);
+}
@@ -0,0 +1,32 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef KEYSEARCH_H
+#define KEYSEARCH_H
+
+#include <stdint.h>
+
+/**
+ * key_prefix ... first 8 bytes of a key as a big-endian integer
+ *
+ *	Shorter keys are padded with zero bytes, so for any two keys
+ *	key_prefix(a) < key_prefix(b) implies strcmp(a, b) < 0, and
+ *	strcmp only needs to run when the prefixes are equal.
+ */
+uint64_t key_prefix(const char *key);
+
+/**
+ * prefix_rank ... search a sorted array of key prefixes
+ *
+ *	Counts the prefixes less than probe, and, if pequal is not NULL,
+ *	stores the number equal to it, so the keys that may equal the
+ *	probe's are at [rank, rank + *pequal). Compares 4 prefixes per
+ *	instruction with AVX2 or 2 with SSE4.2, chosen at run time, and
+ *	falls back to a scalar loop elsewhere.
+ *
+ * @return number of prefixes[0 .. n - 1] less than probe
+ */
+int prefix_rank(const uint64_t *prefixes, int n, uint64_t probe, int *pequal);
+
+#endif
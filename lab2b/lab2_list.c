@@ -2,28 +2,144 @@
 // EMAIL: stephaniekdoan@ucla.edu
 // ID: 604981556
 
-#include "SortedList.h"
+#include "SortedListExt.h"
+#include "LockFreeList.h"
+#include "FineList.h"
+#include "LazyList.h"
+#include "SkipList.h"
+#include "HashTable.h"
+#include "UnrolledList.h"
+#include "RcuList.h"
+#include "epoch.h"
+#include "lock.h"
+#include "affinity.h"
+#include "perf.h"
+#include "keygen.h"
+#include "histogram.h"
+#include "timer.h"
+#include "lockprof.h"
+#include "pool.h"
+#include "combine.h"
 #include <errno.h>
 #include <getopt.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
 #include <time.h>
 
-#define PRIME1 38971
-#define PRIME2 90053
+/* Multipliers for hash_key (the wyhash constants) */
+#define HASH_SEED 0x243f6a8885a308d3ULL
+#define HASH_K1 0xa0761d6478bd642fULL
+#define HASH_K2 0xe7037ed1a0b428dbULL
+#define PAGE_SIZE 4096
+#define CACHE_LINE 64
 
+/* --sync values that pick a list doing its own synchronization:
+ * c lock-free (LockFreeList), g hand-over-hand (FineList),
+ * o optimistic lazy list (LazyList) */
+#define LIST_SYNCS "cgo"
+/* --sync value for RcuList: writers take a mutex, readers take nothing */
+#define RCU_SYNC 'r'
+/* --sync values whose readers may still be on an element after it is deleted */
+#define UNLOCKED_READERS "cor"
+/* --sync values that run every operation on a plain list through a combiner:
+ * p flat combining per sublist, d delegation to one server thread */
+#define COMBINE_SYNCS "pd"
+#define MIX_DEFAULT "25:50:25"
+#define POOL_CHUNK_DEFAULT 64
+
+/* Everything a thread touches to operate on one sublist, padded to whole
+ * cache lines so that neighbouring sublists never share a line */
+typedef struct partition
+{
+    lock_t lock;
+    LockedListElement_t head; /* with a lock and mark, in case --sync is g or o */
+    long long count;          /* elements, kept under lock; see shared_counts */
+    SkipList_t skip;
+    UnrolledList_t unrolled;
+} __attribute__((aligned(CACHE_LINE))) partition_t;
+
+/* Operations of the --duration workload, in --mix order */
+enum mix_op
+{
+    MIX_INSERT,
+    MIX_LOOKUP,
+    MIX_DELETE,
+    MIX_LENGTH,
+    MIX_NOPS
+};
+
+/* --latency histograms: one per mix_op, then lock acquisition */
+#define LAT_LOCK MIX_NOPS
+#define LAT_NKINDS (MIX_NOPS + 1)
+
+/* State of each element in the --duration workload */
+enum mix_state
+{
+    MIX_ABSENT,  /* free to insert */
+    MIX_PRESENT, /* in its sublist */
+    MIX_LIMBO    /* deleted, waiting out readers that may still be on it */
+};
+
+/* Operations a thread completed in the --duration workload, one cache line per thread */
+typedef struct mix_stats
+{
+    long long ops[MIX_NOPS];
+} __attribute__((aligned(CACHE_LINE))) mix_stats_t;
+
+int threads = 1;
 int iterations = 1;
 int lists = 1;
 int opt_yield = 0;
 int opt_sync = '\0';
-SortedList_t *list_arr;
-SortedListElement_t *list_els;
-pthread_mutex_t *mutex_arr; /* sync with mutex */
+int opt_locked = 0; /* opt_sync names a lock kind, so each sublist gets a lock */
+int opt_perf = 0;
+int opt_batch = 1; /* --batch=N: elements inserted or deleted per lock acquisition */
+int opt_length = 'c'; /* --length: c counted, w walk the list, v walk and check against the count */
+int opt_read_ratio = 0; /* --read-ratio=N: read-only lookups per element, on top of insert, length and delete */
+double opt_duration = 0; /* --duration=SECONDS: run the randomized --mix workload for this long instead */
+int mix_pct[MIX_NOPS];   /* --mix=I:L:D[:N] percentages; N is whatever I, L and D leave of 100 */
+char *mix_state;         /* enum mix_state of each element */
+mix_stats_t *mix_arr;
+volatile int mix_stop = 0; /* set by main once --duration is up */
+long long *count_arr; /* per-thread rows of per-sublist element counts, each row whole cache lines */
+int count_stride;     /* counts per row */
+long long *list_counts; /* --layout=packed: one count per sublist, see shared_counts */
+__thread long long *my_counts; /* the calling thread's row */
+perf_counters_t *perf_arr; /* per-thread hardware counters with --perf */
+int opt_latency = 0;        /* --latency: per-operation latency histograms */
+histogram_t *hist_arr;      /* LAT_NKINDS histograms per thread */
+__thread histogram_t *my_hist; /* the calling thread's histograms */
+int opt_tsc = 1;              /* --timer=tsc: time lock waits and --latency with the TSC where it is invariant */
+int opt_lock_stats = 0;       /* --lock-stats: profile every sublist lock, report to stderr */
+lock_profile_t *prof_arr;     /* one per sublist */
+__thread unsigned long long my_hold_start; /* when the calling thread got the sublist lock it holds */
+int opt_pool = 0;   /* --pool: run the phases on a persistent work-stealing pool of --threads workers */
+int opt_chunk = POOL_CHUNK_DEFAULT; /* --chunk=N: elements per pool task */
+int opt_repeat = 1; /* --repeat=N: run the benchmark N times in one process, a CSV line each */
+pool_t pool;
+combiner_t *comb_arr; /* --sync=p: one per sublist; --sync=d: one, with a server thread */
+__thread int my_slot; /* the calling thread's combiner slot: its index, or threads for main */
+int opt_packed = 0; /* --layout=packed: separate, densely packed lock and list arrays */
+int opt_skiplist = 0; /* --structure=skiplist: each sublist is a SkipList */
+int opt_hash = 0;     /* --structure=hash: one resizable HashTable, starting with --lists buckets */
+int opt_unrolled = 0; /* --structure=unrolled: each sublist is an UnrolledList */
+HashTable_t hash_table;
+int opt_hash_stats = 0; /* --hash-stats: print sublist occupancy to stderr */
+partition_t *part_arr;
+LockedListElement_t *list_arr;
+SkipList_t *skip_arr;
+UnrolledList_t *unrolled_arr;
+lock_t *lock_arr; /* one lock per list, of kind opt_sync */
+int opt_heap = 0;              /* --alloc=heap: one element array and a malloc per key */
+char *arena;                   /* one slice per thread: its elements, then their keys */
+size_t slice_size;             /* bytes per thread's slice of the arena or list_els, a whole number of pages */
+SortedListElement_t *list_els; /* --alloc=heap: one slice of elements per thread */
+size_t el_size;                /* bytes per element: a LockedListElement_t for --sync=g and o */
 long long *mutex_wait_times;
-int *spin_lock_arr; /* sync with spin lock */
 
 void print_error(char *error_string, int errnum, int exit_code)
 {
@@ -39,129 +155,835 @@ void sighandler(int num)
     print_error("Run failed, caught signal", num, 1);
 }
 
+/* 64x64->128 bit multiply, folded back to 64 bits */
+static uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+/* wyhash-style hash over the whole key, eight bytes at a time */
+unsigned hash_key(const char *key)
+{
+    size_t len = strlen(key), i;
+    uint64_t hash = HASH_SEED ^ len, word;
+    for (i = 0; i + sizeof(word) <= len; i += sizeof(word))
+    {
+        memcpy(&word, key + i, sizeof(word));
+        hash = hash_mix(hash ^ word, HASH_K1);
+    }
+    word = 0;
+    memcpy(&word, key + i, len - i);
+    hash = hash_mix(hash ^ HASH_K2, word ^ HASH_K1);
+    return (unsigned)(hash ^ (hash >> 32));
+}
+
 int get_list_idx(const char *key)
 {
-    int hash = 19; /* prime number */
-    while (*key)
+    return hash_key(key) % lists;
+}
+
+/* The element i elements of el_size bytes after start */
+SortedListElement_t *element_at(SortedListElement_t *start, size_t i)
+{
+    return (SortedListElement_t *)((char *)start + i * el_size);
+}
+
+/* First of the [iterations] elements a thread inserts */
+SortedListElement_t *thread_els(int thread_idx)
+{
+    char *base = opt_heap ? (char *)list_els : arena;
+    return (SortedListElement_t *)(base + thread_idx * slice_size);
+}
+
+SortedList_t *get_list(int list_idx)
+{
+    return opt_packed ? &list_arr[list_idx].element : &part_arr[list_idx].head.element;
+}
+
+SkipList_t *get_skip(int list_idx)
+{
+    return opt_packed ? &skip_arr[list_idx] : &part_arr[list_idx].skip;
+}
+
+UnrolledList_t *get_unrolled(int list_idx)
+{
+    return opt_packed ? &unrolled_arr[list_idx] : &part_arr[list_idx].unrolled;
+}
+
+lock_t *get_lock(int list_idx)
+{
+    return opt_packed ? &lock_arr[list_idx] : &part_arr[list_idx].lock;
+}
+
+long long *get_count(int list_idx)
+{
+    return opt_packed ? &list_counts[list_idx] : &part_arr[list_idx].count;
+}
+
+/* Kind of the sublist locks: RCU writers serialize on a mutex */
+int lock_kind(void)
+{
+    return RCU_SYNC == opt_sync ? 'm' : opt_sync;
+}
+
+/* Whether every list operation goes through a combiner */
+int combined_lists(void)
+{
+    return opt_sync && strchr(COMBINE_SYNCS, opt_sync);
+}
+
+/* Combiners in comb_arr: delegation has a single server for all the sublists */
+int combiner_count(void)
+{
+    return 'd' == opt_sync ? 1 : lists;
+}
+
+combiner_t *get_combiner(int list_idx)
+{
+    return 'd' == opt_sync ? &comb_arr[0] : &comb_arr[list_idx];
+}
+
+/* Start of the delegation server: its CPU is the one after the threads' */
+void server_init(void)
+{
+    int err = affinity_pin_self(threads);
+    if (0 != err)
+        print_error("Failed to pin delegation server", err, 1);
+}
+
+/* Run by the combiner or server on behalf of a posting thread: one mix_op on a plain sublist */
+intptr_t combine_apply(int op, void *target, void *arg)
+{
+    switch (op)
+    {
+    case MIX_INSERT:
+        SortedList_insert(target, arg);
+        return 0;
+    case MIX_LOOKUP:
+        return (intptr_t)SortedList_lookup(target, arg);
+    case MIX_DELETE:
+        return SortedList_delete(arg);
+    default:
+        return SortedList_length(target);
+    }
+}
+
+/* Post an operation on a sublist to its combiner and wait for the result */
+intptr_t list_combine(int list_idx, int op, void *arg)
+{
+    return combiner_execute(get_combiner(list_idx), my_slot, op, get_list(list_idx), arg);
+}
+
+/* Start timing an operation for --latency, in timer ticks */
+long long lat_start(void)
+{
+    return opt_latency ? (long long)timer_now() : 0;
+}
+
+/* Record the latency of an operation started at start into the calling thread's histogram of that kind */
+void lat_record(int kind, long long start)
+{
+    if (opt_latency)
+        histogram_record(&my_hist[kind], timer_ns(timer_now() - start));
+}
+
+/* Whether sublist lock waits are timed. The spin lock never was, so its
+ * numbers carry no timer cost unless --latency asks for its waits */
+int lock_timed(void)
+{
+    return 's' != opt_sync || opt_latency;
+}
+
+/**
+ * Acquire the lock of a sublist one way or another, returning the time
+ * spent waiting (ns). With --sample=N only every Nth acquisition of a
+ * thread is timed, and counts for the N; the others return 0.
+ * --lock-stats times and profiles every acquisition regardless.
+ */
+long long timed_lock(int list_idx, void (*acquire)(lock_t *), int exclusive)
+{
+    int sampled = lock_timed() && timer_sampled();
+    if (!sampled && !opt_lock_stats)
+    {
+        acquire(get_lock(list_idx));
+        return 0;
+    }
+    int contended = opt_lock_stats ? lockprof_enter(&prof_arr[list_idx], exclusive) : 0;
+    unsigned long long start = timer_now();
+    acquire(get_lock(list_idx));
+    unsigned long long end = timer_now();
+    long long wait = timer_ns(end - start);
+    if (opt_lock_stats)
+    {
+        lockprof_acquired(&prof_arr[list_idx], wait, contended);
+        my_hold_start = end;
+    }
+    if (!sampled)
+        return 0;
+    if (opt_latency)
+        histogram_record(&my_hist[LAT_LOCK], wait);
+    return wait * timer_sample;
+}
+
+/* Release a sublist lock, first counting how long it was held for --lock-stats */
+void timed_unlock(int list_idx, void (*release)(lock_t *), int exclusive)
+{
+    if (opt_lock_stats)
+        lockprof_release(&prof_arr[list_idx], timer_ns(timer_now() - my_hold_start), exclusive);
+    release(get_lock(list_idx));
+}
+
+long long list_lock(int list_idx)
+{
+    if (!opt_locked || opt_hash)
+        return 0;
+    return timed_lock(list_idx, lock_acquire, 1);
+}
+
+void list_unlock(int list_idx)
+{
+    if (opt_locked && !opt_hash)
+        timed_unlock(list_idx, lock_release, 1);
+}
+
+/* Shared acquisition for lookups and length: RCU readers take no lock at all */
+long long list_lock_read(int list_idx)
+{
+    if (!opt_locked || opt_hash || RCU_SYNC == opt_sync)
+        return 0;
+    return timed_lock(list_idx, lock_acquire_read, 0);
+}
+
+void list_unlock_read(int list_idx)
+{
+    if (opt_locked && !opt_hash && RCU_SYNC != opt_sync)
+        timed_unlock(list_idx, lock_release_read, 0);
+}
+
+/* One element of a thread's batch, tagged with its sublist */
+typedef struct batch_entry
+{
+    int list_idx;
+    SortedListElement_t *element;
+} batch_entry_t;
+
+/* Group a batch by sublist, each sublist's elements in key order */
+int batch_cmp(const void *a, const void *b)
+{
+    const batch_entry_t *x = a, *y = b;
+    if (x->list_idx != y->list_idx)
+        return x->list_idx < y->list_idx ? -1 : 1;
+    return strcmp(x->element->key, y->element->key);
+}
+
+/* List operations, dispatched to the structure chosen by --structure
+ * and the list implementation chosen by --sync */
+void list_insert(int list_idx, SortedListElement_t *element)
+{
+    if (opt_hash)
+    {
+        HashTable_insert(&hash_table, element);
+        return;
+    }
+    if (opt_skiplist)
+    {
+        SkipList_insert(get_skip(list_idx), element);
+        return;
+    }
+    if (opt_unrolled)
     {
-        hash = (hash ^ PRIME1) ^ (key[0] * PRIME2);
-        key++;
+        UnrolledList_insert(get_unrolled(list_idx), element);
+        return;
+    }
+    switch (opt_sync)
+    {
+    case 'c':
+        LockFreeList_insert(get_list(list_idx), element);
+        break;
+    case 'g':
+        FineList_insert(get_list(list_idx), element);
+        break;
+    case 'o':
+        LazyList_insert(get_list(list_idx), element);
+        break;
+    case RCU_SYNC:
+        RcuList_insert(get_list(list_idx), element);
+        break;
+    case 'p':
+    case 'd':
+        list_combine(list_idx, MIX_INSERT, element);
+        break;
+    default:
+        SortedList_insert(get_list(list_idx), element);
     }
-    return hash % lists;
 }
 
-void *thread_list(void *start_el)
+int list_delete(int list_idx, SortedListElement_t *element)
 {
-    // Timing mutex synchronization wait
-    long long total_wait = 0; /* ns */
-    struct timespec start_ts, end_ts;
+    if (opt_hash)
+        return HashTable_delete(&hash_table, element);
+    if (opt_skiplist)
+        return SkipList_delete(get_skip(list_idx), element);
+    if (opt_unrolled)
+        return UnrolledList_delete(get_unrolled(list_idx), element);
+    switch (opt_sync)
+    {
+    case 'c':
+        return LockFreeList_delete(get_list(list_idx), element);
+    case 'g':
+        return FineList_delete(get_list(list_idx), element);
+    case 'o':
+        return LazyList_delete(get_list(list_idx), element);
+    case RCU_SYNC:
+        return RcuList_delete(element);
+    case 'p':
+    case 'd':
+        return list_combine(list_idx, MIX_DELETE, element);
+    default:
+        return SortedList_delete(element);
+    }
+}
 
-    // Insert list elements
-    SortedListElement_t *start = (SortedListElement_t *)start_el;
+SortedListElement_t *list_lookup(int list_idx, const char *key)
+{
+    if (opt_hash)
+        return HashTable_lookup(&hash_table, key);
+    if (opt_skiplist)
+        return SkipList_lookup(get_skip(list_idx), key);
+    if (opt_unrolled)
+        return UnrolledList_lookup(get_unrolled(list_idx), key);
+    switch (opt_sync)
+    {
+    case 'c':
+        return LockFreeList_lookup(get_list(list_idx), key);
+    case 'g':
+        return FineList_lookup(get_list(list_idx), key);
+    case 'o':
+        return LazyList_lookup(get_list(list_idx), key);
+    case RCU_SYNC:
+        return RcuList_lookup(get_list(list_idx), key);
+    case 'p':
+    case 'd':
+        return (SortedListElement_t *)list_combine(list_idx, MIX_LOOKUP, (void *)key);
+    default:
+        return SortedList_lookup(get_list(list_idx), key);
+    }
+}
+
+/* Walk a sublist and count its elements */
+int list_walk(int list_idx)
+{
+    if (opt_hash)
+        return HashTable_length(&hash_table);
+    if (opt_skiplist)
+        return SkipList_length(get_skip(list_idx));
+    if (opt_unrolled)
+        return UnrolledList_length(get_unrolled(list_idx));
+    switch (opt_sync)
+    {
+    case 'c':
+        return LockFreeList_length(get_list(list_idx));
+    case 'g':
+        return FineList_length(get_list(list_idx));
+    case 'o':
+        return LazyList_length(get_list(list_idx));
+    case RCU_SYNC:
+        return RcuList_length(get_list(list_idx));
+    case 'p':
+    case 'd':
+        return list_combine(list_idx, MIX_LENGTH, NULL);
+    default:
+        return SortedList_length(get_list(list_idx));
+    }
+}
+
+/* Print how the keys spread over n sublists or buckets to stderr, keeping stdout CSV only */
+void print_hash_stats(int threads, int n)
+{
+    int *occupancy = calloc(n, sizeof(int));
+    int els = threads * iterations;
+    int i, t, min = els, max = 0, empty = 0;
+    if (!occupancy)
+        print_error("Failed to allocate hash statistics", errno, 1);
+    for (t = 0; t < threads; ++t)
+    {
+        for (i = 0; i < iterations; ++i)
+            ++occupancy[hash_key(element_at(thread_els(t), i)->key) % n];
+    }
+    for (i = 0; i < n; ++i)
+    {
+        fprintf(stderr, "list %d: %d\n", i, occupancy[i]);
+        if (occupancy[i] < min)
+            min = occupancy[i];
+        if (occupancy[i] > max)
+            max = occupancy[i];
+        empty += 0 == occupancy[i];
+    }
+    double mean = (double)els / n;
+    fprintf(stderr, "lists %d, elements %d, mean %.2f, min %d, max chain %d (%.2fx mean), empty %d\n", n, els, mean, min,
+            max, mean > 0 ? max / mean : 0, empty);
+    free(occupancy);
+}
+
+/* Whether the sublists are SortedList-shaped, circular lists: plain, combined or RCU */
+int circular_lists(void)
+{
+    return !opt_skiplist && !opt_hash && !opt_unrolled && !(opt_sync && strchr(LIST_SYNCS, opt_sync));
+}
+
+/* Whether the sublists are plain SortedLists used directly, the only lists with batch operations */
+int plain_lists(void)
+{
+    return circular_lists() && RCU_SYNC != opt_sync && !combined_lists();
+}
+
+/* The hash table is one structure, so it keeps a single count */
+int count_idx(int list_idx)
+{
+    return opt_hash ? 0 : list_idx;
+}
+
+/* Whether every change to a sublist holds its lock, so one count per sublist
+ * stays exact; other lists keep a count per thread, summed when read */
+int shared_counts(void)
+{
+    return opt_locked && !opt_hash;
+}
+
+void list_count(int list_idx, int delta)
+{
+    long long *count = shared_counts() ? get_count(list_idx) : &my_counts[count_idx(list_idx)];
+    __atomic_store_n(count, *count + delta, __ATOMIC_RELAXED);
+}
+
+/**
+ * Elements in a sublist: its own count under a sublist lock, otherwise
+ * summed over the threads' counts. Exact while holding the sublist lock,
+ * or once the threads are done; --length=walk and verify walk the list
+ * instead, verify checking every link of a plain list as it goes. RCU
+ * readers hold no lock, so they can only check the walk itself.
+ */
+int list_length(int list_idx)
+{
+    long long counted = 0;
     int i;
-    for (i = 0; i < iterations; ++i)
+    if (shared_counts())
+        counted = __atomic_load_n(get_count(list_idx), __ATOMIC_RELAXED);
+    for (i = 0; !shared_counts() && i < threads; ++i)
+        counted += __atomic_load_n(&count_arr[i * count_stride + count_idx(list_idx)], __ATOMIC_RELAXED);
+    if ('c' == opt_length)
+        return counted;
+
+    int walked = 'v' == opt_length && plain_lists() ? SortedList_verify(get_list(list_idx)) : list_walk(list_idx);
+    if ('v' == opt_length && (walked < 0 || (shared_counts() && RCU_SYNC != opt_sync && walked != counted)))
+        print_error("Length of a list does not match its count", -1, 2);
+    return walked;
+}
+
+/* Several elements of one sublist; lists without batch operations take them one at a time */
+void list_insert_batch(int list_idx, SortedListElement_t **elements, int n)
+{
+    int i;
+    if (n > 1 && plain_lists())
+        SortedList_insert_batch(get_list(list_idx), elements, n);
+    else
     {
-        int list_idx = get_list_idx((start + i)->key);
-        if (opt_sync == 'm')
-        {
-            if (-1 == clock_gettime(CLOCK_MONOTONIC, &start_ts))
-                print_error("Failed to retrieve start time", errno, 1);
-            pthread_mutex_lock(&mutex_arr[list_idx]);
-            if (-1 == clock_gettime(CLOCK_MONOTONIC, &end_ts))
-                print_error("Failed to retrieve end time", errno, 1);
-            total_wait += (end_ts.tv_sec - start_ts.tv_sec) * 1000000000 + (end_ts.tv_nsec - start_ts.tv_nsec);
-            SortedList_insert(&list_arr[list_idx], start + i);
-            pthread_mutex_unlock(&mutex_arr[list_idx]);
-        }
-        else if (opt_sync == 's')
-        {
-            while (__sync_lock_test_and_set(&spin_lock_arr[list_idx], 1))
-                ;
-            SortedList_insert(&list_arr[list_idx], start + i);
-            __sync_lock_release(&spin_lock_arr[list_idx]);
-        }
-        else
-        {
-            SortedList_insert(&list_arr[list_idx], start + i);
-        }
+        for (i = 0; i < n; ++i)
+            list_insert(list_idx, elements[i]);
     }
+}
 
-    // Get length of each list
-    for (i = 0; i < iterations; ++i)
+int list_delete_batch(int list_idx, SortedListElement_t **elements, int n)
+{
+    int i, ret = 0;
+    if (n > 1 && plain_lists())
+        return SortedList_delete_batch(elements, n);
+    for (i = 0; i < n; ++i)
+        ret |= list_delete(list_idx, elements[i]);
+    return ret;
+}
+
+/* Length of the run of one sublist's entries starting at batch[from], copied to elements */
+int next_run(batch_entry_t *batch, int from, int n, SortedListElement_t **elements)
+{
+    int run;
+    for (run = 0; from + run < n && batch[from + run].list_idx == batch[from].list_idx; ++run)
+        elements[run] = batch[from + run].element;
+    return run;
+}
+
+/* Tag the n elements from start with their sublists and sort them into runs */
+void fill_batch(batch_entry_t *batch, SortedListElement_t *start, int n)
+{
+    int i;
+    for (i = 0; i < n; ++i)
     {
-        int list_idx = get_list_idx((start + i)->key);
-        if (opt_sync == 'm')
-        {
-            if (-1 == clock_gettime(CLOCK_MONOTONIC, &start_ts))
-                print_error("Failed to retrieve start time", errno, 1);
-            pthread_mutex_lock(&mutex_arr[list_idx]);
-            if (-1 == clock_gettime(CLOCK_MONOTONIC, &end_ts))
-                print_error("Failed to retrieve end time", errno, 1);
-            total_wait += (end_ts.tv_sec - start_ts.tv_sec) * 1000000000 + (end_ts.tv_nsec - start_ts.tv_nsec);
-            SortedList_length(&list_arr[list_idx]);
-            pthread_mutex_unlock(&mutex_arr[list_idx]);
-        }
-        else if (opt_sync == 's')
+        batch[i].element = element_at(start, i);
+        batch[i].list_idx = get_list_idx(batch[i].element->key);
+    }
+    if (n > 1)
+        qsort(batch, n, sizeof(batch_entry_t), batch_cmp);
+}
+
+/* Per-thread state of the phased benchmark, for threads and pool workers alike */
+__thread batch_entry_t *my_batch;         /* --batch elements, split into one run per sublist */
+__thread SortedListElement_t **my_elements; /* the current run of my_batch */
+__thread long long my_wait;               /* ns waited for locks in the current run */
+
+/* Insert n elements from start, one lock acquisition per run */
+void insert_elements(SortedListElement_t *start, int n)
+{
+    int i, j, size, run;
+    for (i = 0; i < n; i += opt_batch)
+    {
+        size = n - i < opt_batch ? n - i : opt_batch;
+        fill_batch(my_batch, element_at(start, i), size);
+        for (j = 0; j < size; j += run)
         {
-            while (__sync_lock_test_and_set(&spin_lock_arr[list_idx], 1))
-                ;
-            SortedList_length(&list_arr[list_idx]);
-            __sync_lock_release(&spin_lock_arr[list_idx]);
+            int list_idx = my_batch[j].list_idx;
+            run = next_run(my_batch, j, size, my_elements);
+            my_wait += list_lock(list_idx);
+            long long op_start = lat_start();
+            list_insert_batch(list_idx, my_elements, run);
+            lat_record(MIX_INSERT, op_start);
+            list_count(list_idx, run);
+            list_unlock(list_idx);
         }
-        else
+    }
+}
+
+/* Get the length of the sublist of each of n elements, as a reader */
+void length_elements(SortedListElement_t *start, int n)
+{
+    int i;
+    for (i = 0; i < n; ++i)
+    {
+        int list_idx = get_list_idx(element_at(start, i)->key);
+        my_wait += list_lock_read(list_idx);
+        long long op_start = lat_start();
+        list_length(list_idx);
+        lat_record(MIX_LENGTH, op_start);
+        list_unlock_read(list_idx);
+    }
+}
+
+/* One round of read-only lookups of n inserted keys */
+void read_elements(SortedListElement_t *start, int n)
+{
+    int i;
+    for (i = 0; i < n; ++i)
+    {
+        int list_idx = get_list_idx(element_at(start, i)->key);
+        my_wait += list_lock_read(list_idx);
+        long long op_start = lat_start();
+        if (!list_lookup(list_idx, element_at(start, i)->key))
+            print_error("Key can not be found in list", -1, 2);
+        lat_record(MIX_LOOKUP, op_start);
+        list_unlock_read(list_idx);
+    }
+}
+
+/* Look up and delete n inserted keys, one lock acquisition per run */
+void delete_elements(SortedListElement_t *start, int n)
+{
+    int i, j, size, run;
+    for (i = 0; i < n; i += opt_batch)
+    {
+        size = n - i < opt_batch ? n - i : opt_batch;
+        fill_batch(my_batch, element_at(start, i), size);
+        for (j = 0; j < size; j += run)
         {
-            SortedList_length(&list_arr[list_idx]);
+            int list_idx = my_batch[j].list_idx, k;
+            run = next_run(my_batch, j, size, my_elements);
+            my_wait += list_lock(list_idx);
+            for (k = 0; k < run; ++k)
+            {
+                long long op_start = lat_start();
+                my_elements[k] = list_lookup(list_idx, my_elements[k]->key);
+                if (!my_elements[k])
+                    print_error("Key can not be found in list", -1, 2);
+                lat_record(MIX_LOOKUP, op_start);
+            }
+            long long op_start = lat_start();
+            if (1 == list_delete_batch(list_idx, my_elements, run))
+                print_error("Failed to delete element from list", -1, 2);
+            lat_record(MIX_DELETE, op_start);
+            list_count(list_idx, -run);
+            list_unlock(list_idx);
         }
     }
+}
 
-    // Look up and delete inserted keys
-    SortedListElement_t *to_delete = NULL;
+/* Set up a thread or pool worker: its rows of the shared arrays, its CPU and its batch buffers */
+void thread_init(int thread_idx)
+{
+    my_counts = &count_arr[thread_idx * count_stride];
+    my_slot = thread_idx;
+    my_hist = &hist_arr[thread_idx * LAT_NKINDS];
+    int err = affinity_pin_self(thread_idx);
+    if (0 != err)
+        print_error("Failed to pin thread", err, 1);
+    my_batch = malloc(opt_batch * sizeof(batch_entry_t));
+    my_elements = malloc(opt_batch * sizeof(SortedListElement_t *));
+    if (!my_batch || !my_elements)
+        print_error("Failed to allocate batch", errno, 1);
+}
+
+void thread_cleanup(void)
+{
+    free(my_batch);
+    free(my_elements);
+}
+
+void run_begin(int thread_idx)
+{
+    my_wait = 0;
+    if (opt_perf)
+        perf_start(&perf_arr[thread_idx]);
+}
+
+void run_end(int thread_idx)
+{
+    if (opt_hash)
+        my_wait += HashTable_lock_wait();
+    if (opt_locked)
+        mutex_wait_times[thread_idx] = my_wait;
+    if (opt_perf)
+        perf_stop(&perf_arr[thread_idx]);
+}
+
+void *thread_list(void *thread_arg)
+{
+    int thread_idx = (int)(long)thread_arg, j;
+    SortedListElement_t *start = thread_els(thread_idx);
+    thread_init(thread_idx);
+    run_begin(thread_idx);
+    insert_elements(start, iterations);
+    length_elements(start, iterations);
+    for (j = 0; j < opt_read_ratio; ++j)
+        read_elements(start, iterations);
+    delete_elements(start, iterations);
+    run_end(thread_idx);
+    thread_cleanup();
+    return NULL;
+}
+
+/* A phase over the elements of all threads, as one kind of pool task */
+typedef void (*phase_fn)(SortedListElement_t *start, int n);
+
+/* Pool task: elements [begin, end) of all [threads * iterations], a thread's slice at a time */
+void pool_phase(void *arg, int begin, int end, int worker)
+{
+    phase_fn phase = *(phase_fn *)arg;
+    (void)worker;
+    while (begin < end)
+    {
+        int t = begin / iterations, offset = begin % iterations;
+        int n = end - begin < iterations - offset ? end - begin : iterations - offset;
+        phase(element_at(thread_els(t), offset), n);
+        begin += n;
+    }
+}
+
+void pool_begin(void *arg, int worker)
+{
+    (void)arg;
+    run_begin(worker);
+}
+
+void pool_end(void *arg, int worker)
+{
+    (void)arg;
+    run_end(worker);
+}
+
+void pool_cleanup(void *arg, int worker)
+{
+    (void)arg;
+    (void)worker;
+    thread_cleanup();
+}
+
+/* One run of the phased benchmark on the pool, each phase finished everywhere before the next starts */
+void pool_list(void)
+{
+    static phase_fn insert = insert_elements, length = length_elements, read = read_elements,
+                    delete = delete_elements;
+    int els = threads * iterations, j;
+    pool_each(&pool, pool_begin, NULL);
+    pool_run(&pool, pool_phase, &insert, els, opt_chunk);
+    pool_run(&pool, pool_phase, &length, els, opt_chunk);
+    for (j = 0; j < opt_read_ratio; ++j)
+        pool_run(&pool, pool_phase, &read, els, opt_chunk);
+    pool_run(&pool, pool_phase, &delete, els, opt_chunk);
+    pool_each(&pool, pool_end, NULL);
+}
+
+/* Index of an element among all [threads * iterations] */
+int element_idx(SortedListElement_t *element)
+{
+    char *base = opt_heap ? (char *)list_els : arena;
+    int t = ((char *)element - base) / slice_size;
+    return t * iterations + ((char *)element - (char *)thread_els(t)) / el_size;
+}
+
+/* Epoch callback: no reader can still be on a deleted element, so it may be inserted again */
+void mix_release(void *element)
+{
+    __atomic_store_n(&mix_state[element_idx(element)], MIX_ABSENT, __ATOMIC_RELEASE);
+}
+
+/**
+ * Hand back an element deleted by the --duration workload, which put
+ * it in limbo first. Behind a lock it can be inserted again at once,
+ * but readers of the c, o and r lists may still be walking through
+ * it, so those wait out an epoch. The lock-free list retires its own
+ * elements once it unlinks them, and o runs every operation in an
+ * epoch critical section already.
+ */
+void mix_recycle(SortedListElement_t *element)
+{
+    if (!opt_sync || !strchr(UNLOCKED_READERS, opt_sync))
+    {
+        __atomic_store_n(&mix_state[element_idx(element)], MIX_ABSENT, __ATOMIC_RELEASE);
+        return;
+    }
+    if ('c' == opt_sync)
+        return;
+    if (RCU_SYNC == opt_sync)
+        epoch_enter();
+    epoch_retire(element, mix_release);
+    if (RCU_SYNC == opt_sync)
+        epoch_exit();
+}
+
+/* First of the thread's elements in the given state, looking from slot on and wrapping around */
+int mix_find(int thread_idx, int slot, int state)
+{
+    int i;
     for (i = 0; i < iterations; ++i)
     {
-        int list_idx = get_list_idx((start + i)->key);
-        if (opt_sync == 'm')
+        int idx = thread_idx * iterations + (slot + i) % iterations;
+        if (__atomic_load_n(&mix_state[idx], __ATOMIC_ACQUIRE) == state)
+            return (slot + i) % iterations;
+    }
+    return -1;
+}
+
+/* xorshift64, one state per thread */
+unsigned long long mix_random(unsigned long long *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/**
+ * --duration workload: until main sets mix_stop, pick one of the
+ * thread's elements at random and an operation by --mix. An insert
+ * or delete that finds no element to work on looks one up instead.
+ */
+void *thread_mixed(void *thread_arg)
+{
+    int thread_idx = (int)(long)thread_arg;
+    unsigned long long seed = 0x9e3779b97f4a7c15ULL * (thread_idx + 1);
+    thread_init(thread_idx);
+    run_begin(thread_idx);
+
+    SortedListElement_t *start = thread_els(thread_idx);
+    long long *ops = mix_arr[thread_idx].ops;
+    while (!__atomic_load_n(&mix_stop, __ATOMIC_ACQUIRE))
+    {
+        int slot = mix_random(&seed) % iterations, pick = mix_random(&seed) % 100, op, found;
+        for (op = 0; op < MIX_LENGTH && pick >= mix_pct[op]; ++op)
+            pick -= mix_pct[op];
+        if (MIX_INSERT == op && -1 == (found = mix_find(thread_idx, slot, MIX_ABSENT)))
         {
-            if (-1 == clock_gettime(CLOCK_MONOTONIC, &start_ts))
-                print_error("Failed to retrieve start time", errno, 1);
-            pthread_mutex_lock(&mutex_arr[list_idx]);
-            if (-1 == clock_gettime(CLOCK_MONOTONIC, &end_ts))
-                print_error("Failed to retrieve end time", errno, 1);
-            total_wait += (end_ts.tv_sec - start_ts.tv_sec) * 1000000000 + (end_ts.tv_nsec - start_ts.tv_nsec);
-            to_delete = SortedList_lookup(&list_arr[list_idx], (start + i)->key);
-            if (!to_delete)
-                print_error("Key can not be found in list", -1, 2);
-            if (1 == SortedList_delete(to_delete))
-                print_error("Failed to delete element from list", -1, 2);
-            pthread_mutex_unlock(&mutex_arr[list_idx]);
+            // Everything deleted may still be in limbo; try to reclaim some of it first
+            epoch_poll();
+            found = mix_find(thread_idx, slot, MIX_ABSENT);
         }
-        else if (opt_sync == 's')
+        else if (MIX_DELETE == op)
+            found = mix_find(thread_idx, slot, MIX_PRESENT);
+        if ((MIX_INSERT == op || MIX_DELETE == op) && -1 == found)
+            op = MIX_LOOKUP;
+        else if (MIX_INSERT == op || MIX_DELETE == op)
+            slot = found;
+
+        SortedListElement_t *element = element_at(start, slot);
+        int list_idx = get_list_idx(element->key);
+        int present = MIX_PRESENT == mix_state[thread_idx * iterations + slot];
+        if ('o' == opt_sync)
+            epoch_enter();
+        long long op_start;
+        switch (op)
         {
-            while (__sync_lock_test_and_set(&spin_lock_arr[list_idx], 1))
-                ;
-            to_delete = SortedList_lookup(&list_arr[list_idx], (start + i)->key);
-            if (!to_delete)
-                print_error("Key can not be found in list", -1, 2);
-            if (1 == SortedList_delete(to_delete))
+        case MIX_INSERT:
+            my_wait += list_lock(list_idx);
+            op_start = lat_start();
+            list_insert(list_idx, element);
+            lat_record(op, op_start);
+            list_count(list_idx, 1);
+            list_unlock(list_idx);
+            __atomic_store_n(&mix_state[thread_idx * iterations + slot], MIX_PRESENT, __ATOMIC_RELEASE);
+            break;
+        case MIX_DELETE:
+            // In limbo before the list can hand it to mix_release
+            __atomic_store_n(&mix_state[thread_idx * iterations + slot], MIX_LIMBO, __ATOMIC_RELEASE);
+            my_wait += list_lock(list_idx);
+            op_start = lat_start();
+            if (1 == list_delete(list_idx, element))
                 print_error("Failed to delete element from list", -1, 2);
-            __sync_lock_release(&spin_lock_arr[list_idx]);
-        }
-        else
-        {
-            to_delete = SortedList_lookup(&list_arr[list_idx], (start + i)->key);
-            if (!to_delete)
+            lat_record(op, op_start);
+            list_count(list_idx, -1);
+            list_unlock(list_idx);
+            mix_recycle(element);
+            break;
+        case MIX_LOOKUP:
+            // Only our own elements change state, so one we inserted must be found
+            my_wait += list_lock_read(list_idx);
+            op_start = lat_start();
+            if (!list_lookup(list_idx, element->key) && present)
                 print_error("Key can not be found in list", -1, 2);
-            if (1 == SortedList_delete(to_delete))
-                print_error("Failed to delete element from list", -1, 2);
+            lat_record(op, op_start);
+            list_unlock_read(list_idx);
+            break;
+        default:
+            my_wait += list_lock_read(list_idx);
+            op_start = lat_start();
+            list_length(list_idx);
+            lat_record(op, op_start);
+            list_unlock_read(list_idx);
         }
+        if ('o' == opt_sync)
+            epoch_exit();
+        ++ops[op];
     }
 
-    if (opt_sync == 'm')
+    run_end(thread_idx);
+    thread_cleanup();
+    return NULL;
+}
+
+/* Parse --mix=I:L:D[:N], percentages of insert, lookup, delete and length adding up to 100 */
+int parse_mix(const char *arg)
+{
+    int n = sscanf(arg, "%d:%d:%d:%d", &mix_pct[MIX_INSERT], &mix_pct[MIX_LOOKUP], &mix_pct[MIX_DELETE],
+                   &mix_pct[MIX_LENGTH]);
+    if (n < 3)
+        return -1;
+    if (3 == n)
+        mix_pct[MIX_LENGTH] = 100 - mix_pct[MIX_INSERT] - mix_pct[MIX_LOOKUP] - mix_pct[MIX_DELETE];
+    int i, sum = 0;
+    for (i = 0; i < MIX_NOPS; ++i)
     {
-        long long thread_idx = ((SortedListElement_t *)start_el - list_els) / iterations;
-        mutex_wait_times[thread_idx] = total_wait;
+        if (mix_pct[i] < 0)
+            return -1;
+        sum += mix_pct[i];
     }
-
-    return NULL;
+    return 100 == sum ? 0 : -1;
 }
 
 int main(int argc, char *argv[])
@@ -173,12 +995,35 @@ int main(int argc, char *argv[])
         {"iterations", required_argument, 0, 'i'},
         {"yield", required_argument, 0, 'y'},
         {"sync", required_argument, 0, 's'},
+        {"spin", required_argument, 0, 'n'},
+        {"htm-retries", required_argument, 0, 'E'},
+        {"pin", required_argument, 0, 'p'},
+        {"perf", no_argument, 0, 'P'},
+        {"latency", no_argument, 0, 'T'},
+        {"timer", required_argument, 0, 'X'},
+        {"sample", required_argument, 0, 'N'},
+        {"lock-stats", no_argument, 0, 'O'},
+        {"pool", no_argument, 0, 'w'},
+        {"chunk", required_argument, 0, 'k'},
+        {"repeat", required_argument, 0, 'r'},
+        {"layout", required_argument, 0, 'L'},
         {"lists", required_argument, 0, 'l'},
+        {"structure", required_argument, 0, 'S'},
+        {"hash-stats", no_argument, 0, 'H'},
+        {"batch", required_argument, 0, 'B'},
+        {"length", required_argument, 0, 'C'},
+        {"read-ratio", required_argument, 0, 'R'},
+        {"duration", required_argument, 0, 'D'},
+        {"mix", required_argument, 0, 'M'},
+        {"keys", required_argument, 0, 'K'},
+        {"alloc", required_argument, 0, 'A'},
+        {"key-length", required_argument, 0, 'W'},
         {0, 0, 0, 0}};
 
-    int ch = 0, option_index = 0, i = 0;
-    int threads = 1;
-    char *yieldopts = "none", *syncopts = "none";
+    int ch = 0, option_index = 0, i = 0, run;
+    char *yieldopts = "none", *syncopts = "none", *structopts = "list", *lengthopts = "counted";
+    char *keydist = "uniform", *mixopts = NULL;
+    int key_min = 1, key_max = 1;
     while ((ch = getopt_long(argc, argv, "", long_options, &option_index)) != -1)
     {
         switch (ch)
@@ -204,9 +1049,12 @@ int main(int argc, char *argv[])
             yieldopts = optarg;
             break;
         case 's':
-            if (strlen(optarg) == 1 && (optarg[0] == 'm' || optarg[0] == 's'))
+            // A list with its own synchronization, RCU, a combiner, or a lock kind from lock.h
+            if (strlen(optarg) == 1 && (strchr(LIST_SYNCS, optarg[0]) || RCU_SYNC == optarg[0] ||
+                                        strchr(COMBINE_SYNCS, optarg[0]) || lock_valid(optarg[0])))
             {
                 opt_sync = optarg[0];
+                opt_locked = RCU_SYNC == opt_sync || lock_valid(opt_sync);
                 syncopts = optarg;
             }
             else
@@ -215,86 +1063,566 @@ int main(int argc, char *argv[])
         case 'l':
             lists = atoi(optarg);
             break;
+        case 'n':
+            lock_spin_limit = atoi(optarg);
+            if (lock_spin_limit < 0)
+                print_error("Invalid argument to --spin flag", -1, 1);
+            break;
+        case 'E':
+            lock_htm_retries = atoi(optarg);
+            if (lock_htm_retries < 0)
+                print_error("Invalid argument to --htm-retries flag", -1, 1);
+            break;
+        case 'p':
+            if (0 != affinity_init(optarg))
+                print_error("Invalid argument to --pin flag", -1, 1);
+            break;
+        case 'P':
+            opt_perf = 1;
+            break;
+        case 'T':
+            opt_latency = 1;
+            break;
+        case 'X':
+            if (0 == strcmp(optarg, "tsc"))
+                opt_tsc = 1;
+            else if (0 == strcmp(optarg, "clock"))
+                opt_tsc = 0;
+            else
+                print_error("Invalid argument to --timer flag", -1, 1);
+            break;
+        case 'N':
+            timer_sample = atoi(optarg);
+            if (timer_sample < 1)
+                print_error("Invalid argument to --sample flag", -1, 1);
+            break;
+        case 'L':
+            if (0 == strcmp(optarg, "packed"))
+                opt_packed = 1;
+            else if (0 == strcmp(optarg, "padded"))
+                opt_packed = 0;
+            else
+                print_error("Invalid argument to --layout flag", -1, 1);
+            break;
+        case 'K':
+            keydist = optarg;
+            break;
+        case 'W':
+            // N, or MIN-MAX for variable-length keys
+            if (2 != sscanf(optarg, "%d-%d", &key_min, &key_max))
+            {
+                if (1 != sscanf(optarg, "%d", &key_min))
+                    print_error("Invalid argument to --key-length flag", -1, 1);
+                key_max = key_min;
+            }
+            break;
+        case 'A':
+            if (0 == strcmp(optarg, "heap"))
+                opt_heap = 1;
+            else if (0 == strcmp(optarg, "arena"))
+                opt_heap = 0;
+            else
+                print_error("Invalid argument to --alloc flag", -1, 1);
+            break;
+        case 'B':
+            opt_batch = atoi(optarg);
+            if (opt_batch < 1)
+                print_error("Invalid argument to --batch flag", -1, 1);
+            break;
+        case 'C':
+            if (0 == strcmp(optarg, "counted") || 0 == strcmp(optarg, "walk") || 0 == strcmp(optarg, "verify"))
+                opt_length = optarg[0];
+            else
+                print_error("Invalid argument to --length flag", -1, 1);
+            lengthopts = optarg;
+            break;
+        case 'R':
+            opt_read_ratio = atoi(optarg);
+            if (opt_read_ratio < 0)
+                print_error("Invalid argument to --read-ratio flag", -1, 1);
+            break;
+        case 'D':
+            opt_duration = atof(optarg);
+            if (opt_duration <= 0)
+                print_error("Invalid argument to --duration flag", -1, 1);
+            break;
+        case 'M':
+            if (0 != parse_mix(optarg))
+                print_error("Invalid argument to --mix flag", -1, 1);
+            mixopts = optarg;
+            break;
+        case 'H':
+            opt_hash_stats = 1;
+            break;
+        case 'O':
+            opt_lock_stats = 1;
+            break;
+        case 'w':
+            opt_pool = 1;
+            break;
+        case 'k':
+            opt_chunk = atoi(optarg);
+            if (opt_chunk < 1)
+                print_error("Invalid argument to --chunk flag", -1, 1);
+            break;
+        case 'r':
+            opt_repeat = atoi(optarg);
+            if (opt_repeat < 1)
+                print_error("Invalid argument to --repeat flag", -1, 1);
+            break;
+        case 'S':
+            opt_skiplist = 0 == strcmp(optarg, "skiplist");
+            opt_hash = 0 == strcmp(optarg, "hash");
+            opt_unrolled = 0 == strcmp(optarg, "unrolled");
+            if (!opt_skiplist && !opt_hash && !opt_unrolled && 0 != strcmp(optarg, "list"))
+                print_error("Invalid argument to --structure flag", -1, 1);
+            structopts = optarg;
+            break;
         default:
             print_error("Invalid argument", -1, 1);
         }
     }
+    // The skip and unrolled lists run unsynchronized or under a sublist lock, not a list engine
+    if ((opt_skiplist || opt_unrolled) && opt_sync && (!opt_locked || RCU_SYNC == opt_sync))
+        print_error("--structure=skiplist and unrolled only take a lock kind for --sync", -1, 1);
+    // The hash table always locks its buckets, with the kind of lock given by --sync
+    if (opt_hash && (!opt_locked || RCU_SYNC == opt_sync))
+        print_error("--structure=hash needs a lock kind for --sync", -1, 1);
+    // --mix alone runs the mixed workload for a second; it has no phases to batch or add reads to
+    if (mixopts && 0 == opt_duration)
+        opt_duration = 1;
+    if (opt_duration > 0 && !mixopts)
+        parse_mix(mixopts = MIX_DEFAULT);
+    if (opt_duration > 0 && (opt_batch > 1 || opt_read_ratio > 0 || opt_pool || opt_repeat > 1))
+        print_error("--duration does not take --batch, --read-ratio, --pool or --repeat", -1, 1);
+    // The profiler wraps the sublist locks; the hash table keeps its bucket locks to itself
+    if (opt_lock_stats && (!opt_locked || opt_hash))
+        print_error("--lock-stats needs sublist locks: a lock kind or r for --sync, and no --structure=hash", -1, 1);
+    // Its counters are written inside the critical section, so every elided section would conflict
+    if (opt_lock_stats && 't' == opt_sync)
+        print_error("--lock-stats does not take --sync=t", -1, 1);
+    if ('t' == opt_sync && !lock_htm_supported())
+        fprintf(stderr, "RTM is not available, so --sync=t runs on its fallback lock\n");
+    if (opt_duration > 0 && iterations < 1)
+        print_error("--duration needs at least one element per thread", -1, 1);
 
-    // Initialize [threads * iterations] list elements
-    int els = threads * iterations;
-    list_els = (SortedListElement_t *)malloc(els * sizeof(SortedListElement_t));
-    for (i = 0; i < els; ++i)
+    // Initialize [threads * iterations] list elements, with keys from the --keys distribution
+    int els = threads * iterations, t;
+    keygen_t keygen;
+    int err = keygen_init(&keygen, keydist, els, key_min, key_max);
+    if (0 != err)
+        print_error("Invalid --keys or --key-length", err, 1);
+    size_t key_size = keygen_max_length(&keygen) + 1;
+    el_size = 'g' == opt_sync || 'o' == opt_sync ? sizeof(LockedListElement_t) : sizeof(SortedListElement_t);
+    if (opt_heap)
     {
-        // Random character between ASCII 32 (space) and 126 (~)
-        char *rand_char = malloc(sizeof(char));
-        *rand_char = (rand() % (126 - 32)) + 32;
-        (list_els + i)->key = rand_char;
+        // Whole pages per thread, as in the arena, so no two threads' elements share a page
+        slice_size = iterations * el_size;
+        slice_size = (slice_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+        list_els = aligned_alloc(PAGE_SIZE, slice_size * threads);
+        if (!list_els)
+            print_error("Failed to allocate list elements", errno, 1);
     }
-    // Initialize array of [lists] sorted lists
-    list_arr = malloc(lists * sizeof(SortedList_t));
-
-    // If mutex synchronized, initialize array of size [threads] to store total mutex times
-    if (opt_sync == 'm')
+    else
+    {
+        // A thread's elements and keys share its slice, so walking its elements stays in one region
+        slice_size = iterations * (el_size + key_size);
+        slice_size = (slice_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+        arena = aligned_alloc(PAGE_SIZE, slice_size * threads);
+        if (!arena)
+            print_error("Failed to allocate list elements", errno, 1);
+    }
+    if (affinity_enabled())
+    {
+        // Page-aligned and untouched, so each thread's slice is faulted in on its own NUMA node
+        err = affinity_first_touch(opt_heap ? (void *)list_els : (void *)arena, slice_size, threads);
+        if (0 != err)
+            print_error("Failed to place list elements", err, 1);
+    }
+    for (t = 0; t < threads; ++t)
     {
-        mutex_arr = malloc(lists * sizeof(pthread_mutex_t));
+        SortedListElement_t *start = thread_els(t);
+        char *next_key = (char *)element_at(start, iterations);
+        for (i = 0; i < iterations; ++i)
+        {
+            if (opt_heap && !(next_key = malloc(key_size)))
+                print_error("Failed to allocate keys", errno, 1);
+            element_at(start, i)->key = next_key;
+            next_key += keygen_key(&keygen, t * iterations + i, next_key) + 1;
+            if (sizeof(LockedListElement_t) == el_size)
+            {
+                locked_element(element_at(start, i))->lock = 0;
+                locked_element(element_at(start, i))->marked = 0;
+            }
+        }
+    }
+    keygen_destroy(&keygen);
+    // Initialize [lists] sorted lists, each with a lock if synchronized
+    if (opt_packed)
+    {
+        list_arr = calloc(lists, sizeof(LockedListElement_t));
+        lock_arr = calloc(lists, sizeof(lock_t));
+        list_counts = calloc(lists, sizeof(long long));
+        if (opt_skiplist)
+            skip_arr = calloc(lists, sizeof(SkipList_t));
+        if (opt_unrolled)
+            unrolled_arr = calloc(lists, sizeof(UnrolledList_t));
+    }
+    else
+    {
+        part_arr = aligned_alloc(CACHE_LINE, lists * sizeof(partition_t));
+        if (part_arr)
+            memset(part_arr, 0, lists * sizeof(partition_t));
+    }
+    if ((opt_packed && (!list_arr || !lock_arr || !list_counts || (opt_skiplist && !skip_arr) ||
+                        (opt_unrolled && !unrolled_arr))) ||
+        (!opt_packed && !part_arr))
+        print_error("Failed to allocate lists", errno, 1);
+    if (circular_lists())
+    {
+        // Circular empty lists, so a sublist that never sees an insert can still be walked
+        for (i = 0; i < lists; ++i)
+            get_list(i)->next = get_list(i)->prev = get_list(i);
+    }
+    // Element counts, a row per thread so that no two threads write the same cache line
+    count_stride = (lists * sizeof(long long) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE / sizeof(long long);
+    count_arr = aligned_alloc(CACHE_LINE, threads * count_stride * sizeof(long long));
+    if (!count_arr)
+        print_error("Failed to allocate element counts", errno, 1);
+    memset(count_arr, 0, threads * count_stride * sizeof(long long));
+    if (opt_skiplist)
+    {
+        for (i = 0; i < lists; ++i)
+        {
+            if (0 != SkipList_init(get_skip(i)))
+                print_error("Failed to initialize skip list", errno, 1);
+        }
+    }
+    if (opt_hash)
+    {
+        int err = HashTable_init(&hash_table, lists, opt_sync, hash_key);
+        if (0 != err)
+            print_error("Failed to initialize hash table", err, 1);
+    }
+    if (opt_locked)
+    {
+        for (i = 0; i < lists; ++i)
+        {
+            int err = lock_init(get_lock(i), lock_kind());
+            if (0 != err)
+                print_error("Failed to initialize lock", err, 1);
+        }
+        // Array of size [threads] to store total lock wait times
         mutex_wait_times = calloc(threads, sizeof(long long));
+        if (opt_lock_stats)
+        {
+            prof_arr = aligned_alloc(CACHE_LINE, lists * sizeof(lock_profile_t));
+            if (!prof_arr)
+                print_error("Failed to allocate lock statistics", errno, 1);
+            memset(prof_arr, 0, lists * sizeof(lock_profile_t));
+        }
     }
-    if (opt_sync == 's')
-        spin_lock_arr = malloc(lists * sizeof(int));
-
-    // Start clock
-    struct timespec start_ts, end_ts;
-    if (-1 == clock_gettime(CLOCK_MONOTONIC, &start_ts))
-        print_error("Failed to retrieve start time", errno, 1);
 
-    // Run threads
-    pthread_t *thread_arr = malloc(sizeof(pthread_t) * threads);
-    for (i = 0; i < threads; ++i)
+    if (combined_lists())
     {
-        if (0 != pthread_create(/*thread=*/&thread_arr[i], /*attr=*/NULL, thread_list, (void *)&list_els[i * iterations]))
-            print_error("Failed to create thread", errno, 1);
+        // A slot per thread, plus one for main's setup and checks
+        my_slot = threads;
+        comb_arr = aligned_alloc(CACHE_LINE, combiner_count() * sizeof(combiner_t));
+        if (!comb_arr)
+            print_error("Failed to allocate combiners", errno, 1);
+        for (i = 0; i < combiner_count(); ++i)
+        {
+            if (0 != combiner_init(&comb_arr[i], threads + 1, combine_apply))
+                print_error("Failed to initialize combiner", ENOMEM, 1);
+        }
+        if ('d' == opt_sync && 0 != (err = combiner_serve(&comb_arr[0], server_init)))
+            print_error("Failed to start delegation server", err, 1);
     }
-    for (i = 0; i < threads; ++i)
+
+    if (opt_perf)
+        perf_arr = calloc(threads, sizeof(perf_counters_t));
+    // Falls back to clock_gettime by itself if the TSC is not invariant
+    timer_init(opt_tsc);
+    if (opt_latency)
     {
-        if (0 != pthread_join(/*thread=*/thread_arr[i], NULL))
-            print_error("Failed to wait for thread to terminate", errno, 1);
+        hist_arr = calloc(threads * LAT_NKINDS, sizeof(histogram_t));
+        if (!hist_arr)
+            print_error("Failed to allocate latency histograms", errno, 1);
     }
 
-    // End clock
-    if (-1 == clock_gettime(CLOCK_MONOTONIC, &end_ts))
-        print_error("Failed to retrieve end time", errno, 1);
-    long long total_time = (end_ts.tv_sec - start_ts.tv_sec) * 1000000000 + (end_ts.tv_nsec - start_ts.tv_nsec);
-    int ops = 3 * els;
-    long long avg_time = total_time / ops;
-    long long mutex_avg_wait = 0;
-    if (opt_sync == 'm')
+    if (opt_duration > 0)
     {
-        long long mutex_total = 0;
-        for (i = 0; i < threads; ++i)
-            mutex_total += mutex_wait_times[i];
-        mutex_avg_wait = mutex_total / ops;
+        mix_state = calloc(els, sizeof(char));
+        mix_arr = aligned_alloc(CACHE_LINE, threads * sizeof(mix_stats_t));
+        if (!mix_state || !mix_arr)
+            print_error("Failed to allocate workload state", errno, 1);
+        memset(mix_arr, 0, threads * sizeof(mix_stats_t));
+        if ('c' == opt_sync)
+            LockFreeList_free = mix_release;
+        // Start from a steady state: every other element of each thread already in its sublist
+        for (t = 0; t < threads; ++t)
+        {
+            my_counts = &count_arr[t * count_stride];
+            for (i = 0; i < iterations; i += 2)
+            {
+                SortedListElement_t *element = element_at(thread_els(t), i);
+                list_insert(get_list_idx(element->key), element);
+                list_count(get_list_idx(element->key), 1);
+                mix_state[t * iterations + i] = MIX_PRESENT;
+            }
+        }
     }
 
-    // Check that length of each list in list_arr is 0
-    for (i = 0; i < lists; ++i)
+    // Each run starts from empty lists and clean statistics, on the same threads with --pool
+    pthread_t *thread_arr = malloc(sizeof(pthread_t) * threads);
+    if (opt_pool && 0 != (err = pool_init(&pool, threads, thread_init)))
+        print_error("Failed to start thread pool", err, 1);
+    for (run = 0; run < opt_repeat; ++run)
     {
-        if (0 != SortedList_length(&list_arr[i]))
-            print_error("Length of a list is not 0", -1, 2);
+        if (opt_latency)
+            memset(hist_arr, 0, threads * LAT_NKINDS * sizeof(histogram_t));
+        if (opt_hash && run > 0)
+        {
+            // Back to --lists buckets and no resizes; the table is empty and no thread is in it
+            epoch_barrier();
+            HashTable_destroy(&hash_table);
+            if (0 != (err = HashTable_init(&hash_table, lists, opt_sync, hash_key)))
+                print_error("Failed to initialize hash table", err, 1);
+        }
+        for (i = 0; 'h' == opt_sync && i < lists; ++i)
+            lock_hybrid_reset(get_lock(i));
+        if ('t' == opt_sync)
+            lock_htm_reset();
+        for (i = 0; combined_lists() && i < combiner_count(); ++i)
+            comb_arr[i].passes = comb_arr[i].combined = 0;
+
+        // Start clock
+        struct timespec start_ts, end_ts;
+        if (-1 == clock_gettime(CLOCK_MONOTONIC, &start_ts))
+            print_error("Failed to retrieve start time", errno, 1);
+
+        // Run threads, or the pool's workers
+        if (opt_pool)
+            pool_list();
+        for (i = 0; !opt_pool && i < threads; ++i)
+        {
+            if (0 != pthread_create(/*thread=*/&thread_arr[i], /*attr=*/NULL, opt_duration > 0 ? thread_mixed : thread_list,
+                                    (void *)(long)i))
+                print_error("Failed to create thread", errno, 1);
+        }
+        if (opt_duration > 0)
+        {
+            struct timespec duration_ts = {(time_t)opt_duration, (long)((opt_duration - (time_t)opt_duration) * 1e9)};
+            while (-1 == nanosleep(&duration_ts, &duration_ts) && EINTR == errno)
+                ;
+            __atomic_store_n(&mix_stop, 1, __ATOMIC_RELEASE);
+        }
+        for (i = 0; !opt_pool && i < threads; ++i)
+        {
+            if (0 != pthread_join(/*thread=*/thread_arr[i], NULL))
+                print_error("Failed to wait for thread to terminate", errno, 1);
+        }
+
+        // End clock
+        if (-1 == clock_gettime(CLOCK_MONOTONIC, &end_ts))
+            print_error("Failed to retrieve end time", errno, 1);
+        long long total_time = (end_ts.tv_sec - start_ts.tv_sec) * 1000000000 + (end_ts.tv_nsec - start_ts.tv_nsec);
+        long long ops = (3 + opt_read_ratio) * (long long)els, mix_ops[MIX_NOPS] = {0};
+        // Combining passes that ran at least one operation, and operations run, before main's cleanup and checks add theirs
+        long long passes = 0, combined = 0;
+        for (i = 0; combined_lists() && i < combiner_count(); ++i)
+        {
+            passes += comb_arr[i].passes;
+            combined += comb_arr[i].combined;
+        }
+        if (opt_duration > 0)
+        {
+            int op;
+            ops = 0;
+            for (i = 0; i < threads; ++i)
+            {
+                for (op = 0; op < MIX_NOPS; ++op)
+                    mix_ops[op] += mix_arr[i].ops[op];
+            }
+            for (op = 0; op < MIX_NOPS; ++op)
+                ops += mix_ops[op];
+            // Take out whatever the workload left behind, so the lists can be checked empty
+            for (t = 0; t < threads; ++t)
+            {
+                my_counts = &count_arr[t * count_stride];
+                for (i = 0; i < iterations; ++i)
+                {
+                    SortedListElement_t *element = element_at(thread_els(t), i);
+                    if (MIX_PRESENT != mix_state[t * iterations + i])
+                        continue;
+                    if (1 == list_delete(get_list_idx(element->key), element))
+                        print_error("Failed to delete element from list", -1, 2);
+                    list_count(get_list_idx(element->key), -1);
+                }
+            }
+        }
+        long long avg_time = ops ? total_time / ops : 0;
+        long long mutex_avg_wait = 0;
+        if (opt_locked)
+        {
+            long long mutex_total = 0;
+            for (i = 0; i < threads; ++i)
+                mutex_total += mutex_wait_times[i];
+            mutex_avg_wait = ops ? mutex_total / ops : 0;
+        }
+
+        // Check that length of each list is 0, both counted and walked
+        for (i = 0; i < lists; ++i)
+        {
+            if (0 != list_length(i) || 0 != list_walk(i))
+                print_error("Length of a list is not 0", -1, 2);
+        }
+
+        // Log test
+        // Non-default structures get a suffix so they plot as their own series
+        char keyopts[64] = "";
+        // Non-default keys get a suffix too, with their length unless it is the default 1
+        if (0 != strcmp(keydist, "uniform") || key_min != 1 || key_max != 1)
+        {
+            if (key_min == 1 && key_max == 1)
+                snprintf(keyopts, sizeof(keyopts), "-%s", keydist);
+            else if (key_min == key_max)
+                snprintf(keyopts, sizeof(keyopts), "-%s%d", keydist, key_min);
+            else
+                snprintf(keyopts, sizeof(keyopts), "-%s%d-%d", keydist, key_min, key_max);
+        }
+        char batchopts[64] = "";
+        if (opt_batch > 1)
+            snprintf(batchopts, sizeof(batchopts), "-batch%d", opt_batch);
+        if ('c' != opt_length)
+            snprintf(batchopts + strlen(batchopts), sizeof(batchopts) - strlen(batchopts), "-%s", lengthopts);
+        if (opt_read_ratio > 0)
+            snprintf(batchopts + strlen(batchopts), sizeof(batchopts) - strlen(batchopts), "-read%d", opt_read_ratio);
+        if (timer_sample > 1)
+            snprintf(batchopts + strlen(batchopts), sizeof(batchopts) - strlen(batchopts), "-sample%d", timer_sample);
+        if (opt_pool && POOL_CHUNK_DEFAULT == opt_chunk)
+            snprintf(batchopts + strlen(batchopts), sizeof(batchopts) - strlen(batchopts), "-pool");
+        else if (opt_pool)
+            snprintf(batchopts + strlen(batchopts), sizeof(batchopts) - strlen(batchopts), "-pool%d", opt_chunk);
+        if (opt_duration > 0)
+            snprintf(batchopts + strlen(batchopts), sizeof(batchopts) - strlen(batchopts), "-mix%d-%d-%d-%d",
+                     mix_pct[MIX_INSERT], mix_pct[MIX_LOOKUP], mix_pct[MIX_DELETE], mix_pct[MIX_LENGTH]);
+        printf("list-%s-%s%s%s%s%s,%d,%d,%d,%lld,%lld,%lld,%lld", yieldopts, syncopts, strcmp(structopts, "list") ? "-" : "",
+               strcmp(structopts, "list") ? structopts : "", keyopts, batchopts, threads, iterations, lists, ops,
+               total_time, avg_time, mutex_avg_wait);
+        if (opt_duration > 0)
+        {
+            // Throughput of each operation of the mix: inserts, lookups, deletes and lengths per second
+            int op;
+            for (op = 0; op < MIX_NOPS; ++op)
+                printf(",%.0f", mix_ops[op] * 1e9 / total_time);
+        }
+        if (opt_latency)
+        {
+            // Per kind (insert, lookup, delete, length, lock acquisition): p50, p90, p99, p99.9 and max (ns)
+            static const double percents[] = {50, 90, 99, 99.9};
+            histogram_t merged;
+            int kind, p;
+            for (kind = 0; kind < LAT_NKINDS; ++kind)
+            {
+                memset(&merged, 0, sizeof(merged));
+                for (i = 0; i < threads; ++i)
+                    histogram_merge(&merged, &hist_arr[i * LAT_NKINDS + kind]);
+                for (p = 0; p < (int)(sizeof(percents) / sizeof(percents[0])); ++p)
+                    printf(",%lld", histogram_percentile(&merged, percents[p]));
+                printf(",%lld", merged.max);
+            }
+        }
+        if (opt_hash)
+        {
+            // Final bucket count, resizes, total resize time and longest bucket pause (ns)
+            printf(",%d,%lld,%lld,%lld", HashTable_buckets(&hash_table), hash_table.resizes, hash_table.resize_time,
+                   hash_table.pause_max);
+        }
+        if (opt_sync == 'h')
+        {
+            // Hybrid locks: acquisitions won by spinning, and futex waits
+            long long spun = 0, parked = 0;
+            for (i = 0; i < lists; ++i)
+                lock_hybrid_stats(get_lock(i), &spun, &parked);
+            printf(",%lld,%lld", spun, parked);
+        }
+        if (opt_sync == 't')
+        {
+            // Elided locks: commits, aborts by cause and fallback acquisitions
+            long long events[LOCK_HTM_NEVENTS] = {0};
+            lock_htm_stats(events);
+            for (i = 0; i < LOCK_HTM_NEVENTS; ++i)
+                printf(",%lld", events[i]);
+        }
+        if (combined_lists())
+            printf(",%lld,%lld", passes, combined);
+        if (opt_perf)
+        {
+            // Hardware counters summed over all threads
+            long long totals[PERF_NEVENTS] = {0};
+            for (i = 0; i < threads; ++i)
+                perf_sum(totals, &perf_arr[i]);
+            perf_print(totals);
+        }
+        printf("\n");
     }
 
-    // Log test
-    printf("list-%s-%s,%d,%d,%d,%d,%lld,%lld,%lld\n", yieldopts, syncopts, threads, iterations, lists, ops, total_time, avg_time, mutex_avg_wait);
+    // For the hash table, the buckets it had grown to by the end of the run
+    if (opt_hash_stats)
+        print_hash_stats(threads, opt_hash ? HashTable_buckets(&hash_table) : lists);
+    // Sublist locks ranked by contention, to stderr like --hash-stats
+    if (opt_lock_stats)
+    {
+        if (0 != lockprof_report(stderr, "list", prof_arr, lists))
+            print_error("Failed to report lock statistics", ENOMEM, 1);
+        free(prof_arr);
+    }
 
+    if (opt_pool)
+    {
+        pool_each(&pool, pool_cleanup, NULL);
+        pool_destroy(&pool);
+    }
+    for (i = 0; combined_lists() && i < combiner_count(); ++i)
+        combiner_destroy(&comb_arr[i]);
+    free(comb_arr);
     free(thread_arr);
-    for (i = 0; i < els; ++i)
-        free((char *)((list_els + i)->key));
-    free(list_els);
-    if (opt_sync == 'm')
+    free(hist_arr);
+    free(perf_arr);
+    if (opt_heap)
+    {
+        for (t = 0; t < threads; ++t)
+        {
+            for (i = 0; i < iterations; ++i)
+                free((char *)element_at(thread_els(t), i)->key);
+        }
+        free(list_els);
+    }
+    free(arena);
+    if (opt_locked)
     {
-        free(mutex_arr);
+        for (i = 0; i < lists; ++i)
+            lock_destroy(get_lock(i));
         free(mutex_wait_times);
     }
-    if (opt_sync == 's')
-        free(spin_lock_arr);
+    // Towers, bucket arrays and recycled elements still in limbo first, then the (empty) structures themselves
+    epoch_barrier();
+    for (i = 0; opt_skiplist && i < lists; ++i)
+        SkipList_destroy(get_skip(i));
+    if (opt_hash)
+        HashTable_destroy(&hash_table);
+    for (i = 0; opt_unrolled && i < lists; ++i)
+        UnrolledList_destroy(get_unrolled(i));
+    free(part_arr);
+    free(list_arr);
+    free(lock_arr);
+    free(list_counts);
+    free(skip_arr);
+    free(unrolled_arr);
+    free(count_arr);
+    free(mix_state);
+    free(mix_arr);
+    affinity_cleanup();
     return 0;
 }
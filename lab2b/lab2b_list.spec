@@ -0,0 +1,15 @@
+# NAME: Stephanie Doan
+# EMAIL: stephaniekdoan@ucla.edu
+# ID: 604981556
+#
+# sweep.sh matrix for lab2b_list.csv
+
+# List-1, List-2: throughput and mutex wait time vs. threads
+./lab2_list --threads={1,2,4,8,12,16,24} --iterations=1000 --sync={m,s}
+
+# List-3: successful iterations vs. threads; correctness probes, so one run each
+runs=1 warmup=0 ./lab2_list --threads={1,4,8,12,16} --iterations={1,2,4,8,16} --yield=id --lists=4
+runs=1 warmup=0 ./lab2_list --threads={1,4,8,12,16} --iterations={10,20,40,80} --yield=id --lists=4 --sync={m,s}
+
+# List-4, List-5: throughput vs. threads for partitioned lists
+./lab2_list --threads={1,2,4,8,12} --iterations=1000 --lists={4,8,16} --sync={m,s}
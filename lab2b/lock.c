@@ -0,0 +1,612 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "lock.h"
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define LOCK_RTM 1
+#endif
+
+#define BACKOFF_MIN 4
+#define BACKOFF_MAX 1024
+#define HTM_ABORT_LOCKED 0xff /* explicit abort code: the fallback lock is held */
+
+int lock_spin_limit = LOCK_SPIN_DEFAULT;
+int lock_htm_retries = LOCK_HTM_RETRIES_DEFAULT;
+
+/* Per-thread event counts, counted outside transactions so counting never
+ * aborts one. Live threads' counts are on a list for lock_htm_stats; an
+ * exiting thread adds its counts to htm_retired and frees its own. */
+struct htm_counts
+{
+    long long count[LOCK_HTM_NEVENTS];
+    struct htm_counts *next;
+};
+
+static __thread struct htm_counts *htm_self;
+static struct htm_counts *htm_threads;
+static long long htm_retired[LOCK_HTM_NEVENTS];
+static pthread_mutex_t htm_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t htm_key;
+static pthread_once_t htm_key_once = PTHREAD_ONCE_INIT;
+
+/* -1 until checked on first use; racing threads all store the same answer */
+static int htm_supported = -1;
+
+struct mcs_node
+{
+    struct mcs_node *volatile next;
+    volatile int locked;
+};
+
+struct clh_node
+{
+    volatile int locked;
+};
+
+struct rw_slot
+{
+    volatile int readers;
+} __attribute__((aligned(64)));
+
+/* Queue nodes of the calling thread. A CLH node migrates between
+ * threads on every release, so it lives on the heap and is freed by
+ * whichever thread owns it when that thread exits. */
+static __thread struct mcs_node mcs_self;
+static __thread struct clh_node *clh_self;
+static __thread struct clh_node *clh_pred;
+static pthread_key_t clh_key;
+static pthread_once_t clh_key_once = PTHREAD_ONCE_INIT;
+
+/* Reader counter slot of the calling thread, assigned round-robin */
+static __thread int rw_self = -1;
+static int rw_next_slot = 0;
+
+static void clh_key_create(void)
+{
+    pthread_key_create(&clh_key, free);
+}
+
+static struct clh_node *clh_node_get(void)
+{
+    if (!clh_self)
+    {
+        pthread_once(&clh_key_once, clh_key_create);
+        clh_self = malloc(sizeof(struct clh_node));
+        if (!clh_self)
+            abort();
+        pthread_setspecific(clh_key, clh_self);
+    }
+    return clh_self;
+}
+
+static long futex_wait(volatile int *addr, int val)
+{
+    return syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static long futex_wake(volatile int *addr, int count)
+{
+    return syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+int lock_valid(int kind)
+{
+    return kind != '\0' && strchr(LOCK_KINDS, kind) != NULL;
+}
+
+int lock_init(lock_t *lock, int kind)
+{
+    if (!lock_valid(kind))
+        return EINVAL;
+    memset(lock, 0, sizeof(lock_t));
+    lock->kind = kind;
+    switch (kind)
+    {
+    case 'm':
+        return pthread_mutex_init(&lock->u.mutex, NULL);
+    case 'l':
+        /* The queue starts with a released dummy node */
+        lock->u.clh_tail = calloc(1, sizeof(struct clh_node));
+        if (!lock->u.clh_tail)
+            return ENOMEM;
+        break;
+    case 'w':
+        lock->u.rw.slots = aligned_alloc(sizeof(struct rw_slot), LOCK_RW_SLOTS * sizeof(struct rw_slot));
+        if (!lock->u.rw.slots)
+            return ENOMEM;
+        memset(lock->u.rw.slots, 0, LOCK_RW_SLOTS * sizeof(struct rw_slot));
+        break;
+    }
+    return 0;
+}
+
+void lock_destroy(lock_t *lock)
+{
+    switch (lock->kind)
+    {
+    case 'm':
+        pthread_mutex_destroy(&lock->u.mutex);
+        break;
+    case 'l':
+        free(lock->u.clh_tail);
+        lock->u.clh_tail = NULL;
+        break;
+    case 'w':
+        free(lock->u.rw.slots);
+        lock->u.rw.slots = NULL;
+        break;
+    }
+}
+
+static void backoff_acquire(volatile int *word)
+{
+    int delay = BACKOFF_MIN, i;
+    for (;;)
+    {
+        while (__atomic_load_n(word, __ATOMIC_RELAXED))
+            cpu_relax();
+        if (!__atomic_exchange_n(word, 1, __ATOMIC_ACQUIRE))
+            return;
+        for (i = 0; i < delay; ++i)
+            cpu_relax();
+        if (delay < BACKOFF_MAX)
+            delay <<= 1;
+    }
+}
+
+static void ticket_acquire(lock_t *lock)
+{
+    unsigned me = __atomic_fetch_add(&lock->u.ticket.next, 1, __ATOMIC_RELAXED);
+    unsigned owner;
+    while ((owner = __atomic_load_n(&lock->u.ticket.owner, __ATOMIC_ACQUIRE)) != me)
+    {
+        /* Back off in proportion to our distance from the head of the line */
+        unsigned i;
+        for (i = 0; i < (me - owner) * BACKOFF_MIN; ++i)
+            cpu_relax();
+    }
+}
+
+static void mcs_acquire(lock_t *lock)
+{
+    struct mcs_node *me = &mcs_self, *pred;
+    me->next = NULL;
+    me->locked = 1;
+    pred = __atomic_exchange_n(&lock->u.mcs_tail, me, __ATOMIC_ACQ_REL);
+    if (!pred)
+        return;
+    __atomic_store_n(&pred->next, me, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&me->locked, __ATOMIC_ACQUIRE))
+        cpu_relax();
+}
+
+static void mcs_release(lock_t *lock)
+{
+    struct mcs_node *me = &mcs_self, *succ = __atomic_load_n(&me->next, __ATOMIC_ACQUIRE);
+    if (!succ)
+    {
+        struct mcs_node *expected = me;
+        if (__atomic_compare_exchange_n(&lock->u.mcs_tail, &expected, NULL, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            return;
+        /* A successor swapped itself in but has not linked yet */
+        while (!(succ = __atomic_load_n(&me->next, __ATOMIC_ACQUIRE)))
+            cpu_relax();
+    }
+    __atomic_store_n(&succ->locked, 0, __ATOMIC_RELEASE);
+}
+
+static void clh_acquire(lock_t *lock)
+{
+    struct clh_node *me = clh_node_get();
+    me->locked = 1;
+    clh_pred = __atomic_exchange_n(&lock->u.clh_tail, me, __ATOMIC_ACQ_REL);
+    while (__atomic_load_n(&clh_pred->locked, __ATOMIC_ACQUIRE))
+        cpu_relax();
+}
+
+static void clh_release(void)
+{
+    struct clh_node *me = clh_self;
+    /* Recycle the predecessor's node, nobody is spinning on it anymore */
+    clh_self = clh_pred;
+    pthread_setspecific(clh_key, clh_self);
+    __atomic_store_n(&me->locked, 0, __ATOMIC_RELEASE);
+}
+
+/* Futex mutex after Drepper, "Futexes Are Tricky": 0 is unlocked,
+ * 1 is locked, 2 is locked with (possible) waiters. */
+static void futex_acquire(volatile int *word)
+{
+    int c = 0;
+    if (__atomic_compare_exchange_n(word, &c, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return;
+    if (c != 2)
+        c = __atomic_exchange_n(word, 2, __ATOMIC_ACQUIRE);
+    while (c != 0)
+    {
+        futex_wait(word, 2);
+        c = __atomic_exchange_n(word, 2, __ATOMIC_ACQUIRE);
+    }
+}
+
+static void futex_release(volatile int *word)
+{
+    if (__atomic_fetch_sub(word, 1, __ATOMIC_RELEASE) != 1)
+    {
+        __atomic_store_n(word, 0, __ATOMIC_RELEASE);
+        futex_wake(word, 1);
+    }
+}
+
+/* Same protocol as the futex mutex, but spin for a bounded number of
+ * iterations first: a lock held for a short critical section is usually
+ * released before parking (two syscalls) would pay off. */
+static void hybrid_acquire(lock_t *lock)
+{
+    volatile int *word = &lock->u.hybrid.word;
+    int c = 0, i;
+    long long parked = 0;
+    if (__atomic_compare_exchange_n(word, &c, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return;
+    for (i = 0; i < lock_spin_limit; ++i)
+    {
+        cpu_relax();
+        c = 0;
+        if (__atomic_load_n(word, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(word, &c, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            ++lock->u.hybrid.spun;
+            return;
+        }
+    }
+    c = __atomic_exchange_n(word, 2, __ATOMIC_ACQUIRE);
+    while (c != 0)
+    {
+        ++parked;
+        futex_wait(word, 2);
+        c = __atomic_exchange_n(word, 2, __ATOMIC_ACQUIRE);
+    }
+    lock->u.hybrid.parked += parked;
+}
+
+void spin_acquire(volatile int *word)
+{
+    int spins = 0;
+    for (;;)
+    {
+        if (!__atomic_load_n(word, __ATOMIC_RELAXED) && !__atomic_exchange_n(word, 1, __ATOMIC_ACQUIRE))
+            return;
+        if (++spins < lock_spin_limit)
+            cpu_relax();
+        else
+        {
+            spins = 0;
+            sched_yield();
+        }
+    }
+}
+
+void spin_release(volatile int *word)
+{
+    __atomic_store_n(word, 0, __ATOMIC_RELEASE);
+}
+
+/* Writer side: exclude other writers and new readers, then wait out the readers inside */
+static void rw_acquire(lock_t *lock)
+{
+    int i;
+    spin_acquire(&lock->u.rw.writer);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (i = 0; i < LOCK_RW_SLOTS; ++i)
+    {
+        int spins = 0;
+        while (__atomic_load_n(&lock->u.rw.slots[i].readers, __ATOMIC_ACQUIRE))
+        {
+            if (++spins < lock_spin_limit)
+                cpu_relax();
+            else
+            {
+                spins = 0;
+                sched_yield();
+            }
+        }
+    }
+}
+
+void lock_acquire_read(lock_t *lock)
+{
+    if (lock->kind != 'w')
+    {
+        lock_acquire(lock);
+        return;
+    }
+    if (rw_self < 0)
+        rw_self = __atomic_fetch_add(&rw_next_slot, 1, __ATOMIC_RELAXED) % LOCK_RW_SLOTS;
+    volatile int *readers = &lock->u.rw.slots[rw_self].readers;
+    for (;;)
+    {
+        // Announce ourselves, then back out again if a writer got there first
+        __atomic_fetch_add(readers, 1, __ATOMIC_SEQ_CST);
+        if (!__atomic_load_n(&lock->u.rw.writer, __ATOMIC_SEQ_CST))
+            return;
+        __atomic_fetch_sub(readers, 1, __ATOMIC_RELEASE);
+        spin_acquire(&lock->u.rw.writer);
+        spin_release(&lock->u.rw.writer);
+    }
+}
+
+void lock_release_read(lock_t *lock)
+{
+    if (lock->kind != 'w')
+    {
+        lock_release(lock);
+        return;
+    }
+    __atomic_fetch_sub(&lock->u.rw.slots[rw_self].readers, 1, __ATOMIC_RELEASE);
+}
+
+void lock_hybrid_stats(lock_t *lock, long long *spun, long long *parked)
+{
+    if (lock->kind != 'h')
+        return;
+    *spun += lock->u.hybrid.spun;
+    *parked += lock->u.hybrid.parked;
+}
+
+void lock_hybrid_reset(lock_t *lock)
+{
+    if (lock->kind != 'h')
+        return;
+    lock->u.hybrid.spun = 0;
+    lock->u.hybrid.parked = 0;
+}
+
+int lock_htm_supported(void)
+{
+    int supported = __atomic_load_n(&htm_supported, __ATOMIC_RELAXED);
+    if (supported < 0)
+    {
+        supported = 0;
+#ifdef LOCK_RTM
+        unsigned eax, ebx, ecx, edx;
+        // CPUID leaf 7, EBX bit 11
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            supported = (ebx >> 11) & 1;
+#endif
+        __atomic_store_n(&htm_supported, supported, __ATOMIC_RELAXED);
+    }
+    return supported;
+}
+
+void lock_htm_stats(long long counts[LOCK_HTM_NEVENTS])
+{
+    struct htm_counts *counts_of;
+    int i;
+    pthread_mutex_lock(&htm_mutex);
+    for (i = 0; i < LOCK_HTM_NEVENTS; ++i)
+        counts[i] += htm_retired[i];
+    for (counts_of = htm_threads; counts_of; counts_of = counts_of->next)
+    {
+        for (i = 0; i < LOCK_HTM_NEVENTS; ++i)
+            counts[i] += __atomic_load_n(&counts_of->count[i], __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&htm_mutex);
+}
+
+void lock_htm_reset(void)
+{
+    struct htm_counts *counts_of;
+    int i;
+    pthread_mutex_lock(&htm_mutex);
+    memset(htm_retired, 0, sizeof(htm_retired));
+    for (counts_of = htm_threads; counts_of; counts_of = counts_of->next)
+    {
+        for (i = 0; i < LOCK_HTM_NEVENTS; ++i)
+            __atomic_store_n(&counts_of->count[i], 0, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&htm_mutex);
+}
+
+/* Key destructor: fold an exiting thread's counts into htm_retired */
+static void htm_counts_retire(void *ptr)
+{
+    struct htm_counts *self = ptr, **link;
+    int i;
+    pthread_mutex_lock(&htm_mutex);
+    for (link = &htm_threads; *link != self; link = &(*link)->next)
+        ;
+    *link = self->next;
+    for (i = 0; i < LOCK_HTM_NEVENTS; ++i)
+        htm_retired[i] += self->count[i];
+    pthread_mutex_unlock(&htm_mutex);
+    free(self);
+}
+
+static void htm_key_create(void)
+{
+    pthread_key_create(&htm_key, htm_counts_retire);
+}
+
+static void htm_count(int event)
+{
+    if (!htm_self)
+    {
+        pthread_once(&htm_key_once, htm_key_create);
+        htm_self = calloc(1, sizeof(struct htm_counts));
+        if (!htm_self)
+            abort();
+        pthread_mutex_lock(&htm_mutex);
+        htm_self->next = htm_threads;
+        htm_threads = htm_self;
+        pthread_mutex_unlock(&htm_mutex);
+        pthread_setspecific(htm_key, htm_self);
+    }
+    // Only this thread writes its counts; the atomic store keeps readers from tearing them
+    __atomic_store_n(&htm_self->count[event], htm_self->count[event] + 1, __ATOMIC_RELAXED);
+}
+
+#ifdef LOCK_RTM
+static int htm_abort_event(unsigned status)
+{
+    if ((status & _XABORT_EXPLICIT) && HTM_ABORT_LOCKED == _XABORT_CODE(status))
+        return LOCK_HTM_LOCKED;
+    if (status & _XABORT_CONFLICT)
+        return LOCK_HTM_CONFLICT;
+    if (status & _XABORT_CAPACITY)
+        return LOCK_HTM_CAPACITY;
+    return LOCK_HTM_OTHER;
+}
+
+/**
+ * Start the critical section as a transaction. The fallback lock word
+ * is read inside it, so a thread taking the fallback lock aborts every
+ * transaction in flight. Aborts the hardware does not expect to go away
+ * on a retry (no _XABORT_RETRY hint, say a capacity abort) go straight
+ * to the fallback lock, except for finding the lock held.
+ */
+__attribute__((target("rtm"))) static int htm_begin(lock_t *lock)
+{
+    int attempt;
+    for (attempt = 0; attempt < lock_htm_retries; ++attempt)
+    {
+        // A transaction started while the lock is held would only abort
+        int spins = 0;
+        while (__atomic_load_n(&lock->u.word, __ATOMIC_RELAXED))
+        {
+            if (++spins < lock_spin_limit)
+                cpu_relax();
+            else
+            {
+                spins = 0;
+                sched_yield();
+            }
+        }
+        unsigned status = _xbegin();
+        if (_XBEGIN_STARTED == status)
+        {
+            if (!lock->u.word)
+                return 1;
+            _xabort(HTM_ABORT_LOCKED);
+        }
+        int event = htm_abort_event(status);
+        htm_count(event);
+        if (LOCK_HTM_LOCKED != event && !(status & _XABORT_RETRY))
+            break;
+    }
+    return 0;
+}
+
+/* Commit if the section ran as a transaction; otherwise the caller holds the fallback lock */
+__attribute__((target("rtm"))) static int htm_end(void)
+{
+    if (!_xtest())
+        return 0;
+    _xend();
+    htm_count(LOCK_HTM_COMMITS);
+    return 1;
+}
+#endif
+
+static void htm_acquire(lock_t *lock)
+{
+#ifdef LOCK_RTM
+    if (lock_htm_supported() && htm_begin(lock))
+        return;
+#endif
+    htm_count(LOCK_HTM_FALLBACKS);
+    spin_acquire(&lock->u.word);
+}
+
+static void htm_release(lock_t *lock)
+{
+#ifdef LOCK_RTM
+    if (lock_htm_supported() && htm_end())
+        return;
+#endif
+    spin_release(&lock->u.word);
+}
+
+void lock_acquire(lock_t *lock)
+{
+    switch (lock->kind)
+    {
+    case 'm':
+        pthread_mutex_lock(&lock->u.mutex);
+        break;
+    case 's':
+        while (__sync_lock_test_and_set(&lock->u.word, 1))
+            ;
+        break;
+    case 'b':
+        backoff_acquire(&lock->u.word);
+        break;
+    case 'k':
+        ticket_acquire(lock);
+        break;
+    case 'q':
+        mcs_acquire(lock);
+        break;
+    case 'l':
+        clh_acquire(lock);
+        break;
+    case 'f':
+        futex_acquire(&lock->u.word);
+        break;
+    case 'h':
+        hybrid_acquire(lock);
+        break;
+    case 'w':
+        rw_acquire(lock);
+        break;
+    case 't':
+        htm_acquire(lock);
+        break;
+    }
+}
+
+void lock_release(lock_t *lock)
+{
+    switch (lock->kind)
+    {
+    case 'm':
+        pthread_mutex_unlock(&lock->u.mutex);
+        break;
+    case 's':
+    case 'b':
+        __sync_lock_release(&lock->u.word);
+        break;
+    case 'k':
+        __atomic_store_n(&lock->u.ticket.owner, lock->u.ticket.owner + 1, __ATOMIC_RELEASE);
+        break;
+    case 'q':
+        mcs_release(lock);
+        break;
+    case 'l':
+        clh_release();
+        break;
+    case 'f':
+        futex_release(&lock->u.word);
+        break;
+    case 'h':
+        futex_release(&lock->u.hybrid.word);
+        break;
+    case 'w':
+        spin_release(&lock->u.rw.writer);
+        break;
+    case 't':
+        htm_release(lock);
+        break;
+    }
+}
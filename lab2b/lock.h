@@ -0,0 +1,189 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef LOCK_H
+#define LOCK_H
+
+#include <pthread.h>
+
+/**
+ * lock_t
+ *
+ *	A lock whose algorithm is picked at initialization time. The
+ *	kind of a lock is the --sync letter that selects it, so the
+ *	drivers can pass opt_sync straight through:
+ *
+ *	  m  pthread mutex
+ *	  s  test-and-set spin lock
+ *	  b  test-and-test-and-set spin lock with exponential backoff
+ *	  k  ticket lock (FIFO, spins on a shared counter)
+ *	  q  MCS queue lock (FIFO, spins on a thread-local node)
+ *	  l  CLH queue lock (FIFO, spins on the predecessor's node)
+ *	  f  futex mutex (one CAS when uncontended, sleeps in the kernel
+ *	     when contended)
+ *	  h  hybrid lock: spins up to lock_spin_limit times, then parks
+ *	     on a futex, so oversubscribed threads stop burning CPU
+ *	  w  reader-writer lock: readers only touch a counter of their
+ *	     own (see lock_acquire_read), writers wait for every reader
+ *	     counter to drain
+ *	  t  transactional lock elision: the critical section runs as an
+ *	     RTM transaction, retried up to lock_htm_retries times, and
+ *	     only then under a test-and-test-and-set fallback lock; where
+ *	     the CPU has no RTM it is just the fallback lock
+ *
+ *	A thread may hold at most one q or l lock at a time, since the
+ *	queue node it spins on is kept in thread-local storage.
+ */
+#define LOCK_KINDS "msbkqlfhwt"
+#define LOCK_SPIN_DEFAULT 128
+#define LOCK_RW_SLOTS 64 /* reader counters per reader-writer lock */
+#define LOCK_HTM_RETRIES_DEFAULT 5
+
+/* Outcomes of elided (t) critical sections, counted over all t locks */
+enum lock_htm_event
+{
+    LOCK_HTM_COMMITS,   /* sections that committed as transactions */
+    LOCK_HTM_CONFLICT,  /* aborts on a data conflict with another thread */
+    LOCK_HTM_CAPACITY,  /* aborts because the section outgrew the transactional cache */
+    LOCK_HTM_LOCKED,    /* aborts because the fallback lock was held */
+    LOCK_HTM_OTHER,     /* other aborts: system calls (--yield), interrupts, debug */
+    LOCK_HTM_FALLBACKS, /* sections run under the fallback lock instead */
+    LOCK_HTM_NEVENTS
+};
+
+struct mcs_node;
+struct clh_node;
+struct rw_slot;
+
+typedef struct lock
+{
+    int kind;
+    union
+    {
+        pthread_mutex_t mutex;
+        volatile int word;
+        struct
+        {
+            volatile unsigned next;
+            volatile unsigned owner;
+        } ticket;
+        struct mcs_node *volatile mcs_tail;
+        struct clh_node *volatile clh_tail;
+        struct
+        {
+            volatile int word;
+            /* Updated by the owner while it holds the lock */
+            long long spun;   /* acquisitions that succeeded while spinning */
+            long long parked; /* futex waits before acquisition */
+        } hybrid;
+        struct
+        {
+            volatile int writer;   /* held by the writer, and stops new readers */
+            struct rw_slot *slots; /* LOCK_RW_SLOTS reader counters, one per cache line */
+        } rw;
+    } u;
+} lock_t;
+
+/**
+ * lock_spin_limit ... iterations a hybrid lock spins before parking
+ */
+extern int lock_spin_limit;
+
+/**
+ * lock_htm_retries ... transactions a t lock attempts before taking its fallback lock
+ */
+extern int lock_htm_retries;
+
+/**
+ * cpu_relax ... hint to the CPU that we are in a spin-wait loop
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define cpu_relax() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define cpu_relax() __asm__ __volatile__("" ::: "memory")
+#endif
+
+/**
+ * lock_valid ... check whether a character names a lock kind
+ *
+ * @return 1 if kind is one of LOCK_KINDS, 0 otherwise
+ */
+int lock_valid(int kind);
+
+/**
+ * lock_init ... initialize a lock of the given kind
+ *
+ * @return 0 on success, an errno value on failure
+ */
+int lock_init(lock_t *lock, int kind);
+
+/**
+ * lock_destroy ... release any resources owned by an unheld lock
+ */
+void lock_destroy(lock_t *lock);
+
+void lock_acquire(lock_t *lock);
+void lock_release(lock_t *lock);
+
+/**
+ * lock_acquire_read, lock_release_read ... shared acquisition
+ *
+ *	For a w lock, any number of readers may hold the lock at once.
+ *	Each thread counts itself in one of LOCK_RW_SLOTS per-slot reader
+ *	counters (threads take slots round-robin, so with pinned threads
+ *	a slot is in effect per CPU), so readers on different slots never
+ *	write the same cache line. Writers are preferred: a waiting writer
+ *	holds off new readers. Other lock kinds are simply acquired.
+ */
+void lock_acquire_read(lock_t *lock);
+void lock_release_read(lock_t *lock);
+
+/**
+ * spin_acquire, spin_release ... a one-word test-and-test-and-set lock
+ *
+ *	For locking individual list elements, where a lock_t would be too
+ *	big. After lock_spin_limit failed attempts the waiter yields the
+ *	CPU, so lock coupling stays usable with more threads than CPUs.
+ *	A zeroed word is unlocked.
+ */
+void spin_acquire(volatile int *word);
+void spin_release(volatile int *word);
+
+/**
+ * lock_hybrid_stats ... add a hybrid lock's spin and park counts
+ *	to *spun and *parked. Other lock kinds add nothing.
+ */
+void lock_hybrid_stats(lock_t *lock, long long *spun, long long *parked);
+
+/**
+ * lock_hybrid_reset ... zero a hybrid lock's spin and park counts,
+ *	e.g. between runs. Other lock kinds are left alone.
+ */
+void lock_hybrid_reset(lock_t *lock);
+
+/**
+ * lock_htm_supported ... check whether the CPU can elide t locks
+ *
+ * @return 1 if RTM is available, 0 if t locks always take their fallback lock
+ */
+int lock_htm_supported(void);
+
+/**
+ * lock_htm_stats ... add the counts of each lock_htm_event, over all
+ *	t locks and threads since the last lock_htm_reset, to counts[]
+ *
+ *	Each thread counts its own events; this sums them, so it is
+ *	exact once the threads using t locks are done.
+ */
+void lock_htm_stats(long long counts[LOCK_HTM_NEVENTS]);
+
+/**
+ * lock_htm_reset ... zero the lock_htm_event counts, e.g. between runs
+ *	while no thread is using a t lock
+ */
+void lock_htm_reset(void);
+
+#endif
@@ -0,0 +1,85 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "lockprof.h"
+#include <errno.h>
+#include <stdlib.h>
+
+static void atomic_max(long long *max, long long value)
+{
+    long long cur = __atomic_load_n(max, __ATOMIC_RELAXED);
+    while (value > cur && !__atomic_compare_exchange_n(max, &cur, value, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+int lockprof_enter(lock_profile_t *prof, int exclusive)
+{
+    int others = __atomic_fetch_add(&prof->inside, 1, __ATOMIC_SEQ_CST);
+    if (!exclusive)
+        return __atomic_load_n(&prof->exclusive, __ATOMIC_SEQ_CST) > 0;
+    __atomic_fetch_add(&prof->exclusive, 1, __ATOMIC_SEQ_CST);
+    return others > 0;
+}
+
+void lockprof_acquired(lock_profile_t *prof, long long wait, int contended)
+{
+    __atomic_fetch_add(&prof->acquisitions, 1, __ATOMIC_RELAXED);
+    if (contended)
+        __atomic_fetch_add(&prof->contended, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&prof->wait_total, wait, __ATOMIC_RELAXED);
+    atomic_max(&prof->wait_max, wait);
+}
+
+void lockprof_release(lock_profile_t *prof, long long hold, int exclusive)
+{
+    __atomic_fetch_add(&prof->hold_total, hold, __ATOMIC_RELAXED);
+    atomic_max(&prof->hold_max, hold);
+    if (exclusive)
+        __atomic_fetch_sub(&prof->exclusive, 1, __ATOMIC_SEQ_CST);
+    __atomic_fetch_sub(&prof->inside, 1, __ATOMIC_SEQ_CST);
+}
+
+static const lock_profile_t *rank_base;
+
+/* Most total wait first, then lowest index */
+static int rank_cmp(const void *a, const void *b)
+{
+    const lock_profile_t *x = &rank_base[*(const int *)a], *y = &rank_base[*(const int *)b];
+    if (x->wait_total != y->wait_total)
+        return x->wait_total > y->wait_total ? -1 : 1;
+    return *(const int *)a - *(const int *)b;
+}
+
+int lockprof_report(FILE *out, const char *label, const lock_profile_t *profs, int n)
+{
+    int *order = malloc(n * sizeof(int));
+    long long wait_all = 0;
+    int i, used = 0;
+    if (!order)
+        return ENOMEM;
+    for (i = 0; i < n; ++i)
+    {
+        order[i] = i;
+        wait_all += profs[i].wait_total;
+    }
+    rank_base = profs;
+    qsort(order, n, sizeof(int), rank_cmp);
+    for (i = 0; i < n; ++i)
+    {
+        const lock_profile_t *prof = &profs[order[i]];
+        if (0 == prof->acquisitions)
+            continue;
+        ++used;
+        fprintf(out,
+                "%s %d: acquisitions %lld, contended %lld (%.1f%%), wait total %lld max %lld, hold total %lld "
+                "max %lld (ns)\n",
+                label, order[i], prof->acquisitions, prof->contended, 100.0 * prof->contended / prof->acquisitions,
+                prof->wait_total, prof->wait_max, prof->hold_total, prof->hold_max);
+    }
+    if (used > 0)
+        fprintf(out, "%d of %d %ss acquired, the top one with %.1f%% of all %lld ns of waiting\n", used, n, label,
+                wait_all ? 100.0 * profs[order[0]].wait_total / wait_all : 0, wait_all);
+    free(order);
+    return 0;
+}
@@ -0,0 +1,64 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef LOCKPROF_H
+#define LOCKPROF_H
+
+#include <stdio.h>
+
+/**
+ * lock_profile_t
+ *
+ *	Contention statistics for one lock, kept by whoever wraps its
+ *	acquire and release calls:
+ *
+ *	  lockprof_enter     before acquiring (notes whether it is contended)
+ *	  lockprof_acquired  once acquired, with the time spent waiting
+ *	  lockprof_release   before releasing, with the time it was held
+ *
+ *	An acquisition is contended if another thread was holding or
+ *	waiting for the lock when it started; shared (reader) acquisitions
+ *	only contend with exclusive ones. All updates are atomic, so
+ *	readers holding the lock together may update it at once. A zeroed
+ *	lock_profile_t is ready to use.
+ */
+typedef struct lock_profile
+{
+    volatile int inside;    /* threads between lockprof_enter and lockprof_release */
+    volatile int exclusive; /* how many of them want or hold it exclusively */
+    long long acquisitions;
+    long long contended;
+    long long wait_total, wait_max; /* ns */
+    long long hold_total, hold_max; /* ns */
+} __attribute__((aligned(64))) lock_profile_t;
+
+/**
+ * lockprof_enter ... note a thread about to acquire the lock
+ *
+ * @return 1 if the acquisition is contended, 0 otherwise
+ */
+int lockprof_enter(lock_profile_t *prof, int exclusive);
+
+/**
+ * lockprof_acquired ... count an acquisition and the time it waited
+ */
+void lockprof_acquired(lock_profile_t *prof, long long wait, int contended);
+
+/**
+ * lockprof_release ... count the time the lock was held, before releasing it
+ */
+void lockprof_release(lock_profile_t *prof, long long hold, int exclusive);
+
+/**
+ * lockprof_report ... print the locks ranked by total wait, most contended first
+ *
+ *	One line per lock that was acquired at all, named by label and its
+ *	index, then a summary of how much of all waiting the top lock
+ *	accounts for.
+ *
+ * @return 0, or ENOMEM
+ */
+int lockprof_report(FILE *out, const char *label, const lock_profile_t *profs, int n);
+
+#endif
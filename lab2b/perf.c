@@ -0,0 +1,96 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "perf.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+static const struct
+{
+    unsigned type;
+    unsigned long long config;
+} events[PERF_NEVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+
+void perf_start(perf_counters_t *pc)
+{
+    struct perf_event_attr attr;
+    int i;
+    for (i = 0; i < PERF_NEVENTS; ++i)
+    {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[i].type;
+        attr.config = events[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        /* Context switches happen in the kernel, so they must count it */
+        if (events[i].type == PERF_TYPE_SOFTWARE)
+            attr.exclude_kernel = 0;
+        pc->fd[i] = syscall(SYS_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1, /*group_fd=*/-1, 0);
+        pc->value[i] = -1;
+    }
+    for (i = 0; i < PERF_NEVENTS; ++i)
+    {
+        if (pc->fd[i] >= 0)
+            ioctl(pc->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void perf_stop(perf_counters_t *pc)
+{
+    /* value, time enabled, time running */
+    unsigned long long buf[3];
+    int i;
+    for (i = 0; i < PERF_NEVENTS; ++i)
+    {
+        if (pc->fd[i] >= 0)
+            ioctl(pc->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (i = 0; i < PERF_NEVENTS; ++i)
+    {
+        if (pc->fd[i] < 0)
+            continue;
+        if (sizeof(buf) == read(pc->fd[i], buf, sizeof(buf)))
+        {
+            if (buf[2] > 0 && buf[2] < buf[1])
+                pc->value[i] = (long long)((double)buf[0] * buf[1] / buf[2]);
+            else
+                pc->value[i] = (long long)buf[0];
+        }
+        close(pc->fd[i]);
+        pc->fd[i] = -1;
+    }
+}
+
+void perf_sum(long long totals[PERF_NEVENTS], const perf_counters_t *pc)
+{
+    int i;
+    for (i = 0; i < PERF_NEVENTS; ++i)
+    {
+        if (totals[i] < 0 || pc->value[i] < 0)
+            totals[i] = -1;
+        else
+            totals[i] += pc->value[i];
+    }
+}
+
+void perf_print(const long long totals[PERF_NEVENTS])
+{
+    int i;
+    for (i = 0; i < PERF_NEVENTS; ++i)
+        printf(",%lld", totals[i]);
+}
@@ -0,0 +1,54 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef PERF_H
+#define PERF_H
+
+/**
+ * perf_counters_t
+ *
+ *	Hardware and software counters for the calling thread, read with
+ *	perf_event_open(2). The events, in the order they are appended to
+ *	the CSV line, are:
+ *
+ *	  cycles, instructions, cache misses, LLC read misses,
+ *	  context switches
+ *
+ *	Counters the kernel or CPU cannot provide (e.g. hardware events in
+ *	a VM, or perf_event_paranoid too high) read as -1 instead of
+ *	failing the run. Values are scaled up if the kernel had to
+ *	multiplex the hardware counters.
+ */
+#define PERF_NEVENTS 5
+
+typedef struct perf_counters
+{
+    int fd[PERF_NEVENTS];
+    long long value[PERF_NEVENTS];
+} perf_counters_t;
+
+/**
+ * perf_start ... open and enable counters for the calling thread
+ */
+void perf_start(perf_counters_t *pc);
+
+/**
+ * perf_stop ... disable and read counters into pc->value, then close them
+ */
+void perf_stop(perf_counters_t *pc);
+
+/**
+ * perf_sum ... add per-thread counters into totals
+ *
+ *	An event unavailable in any thread stays -1 in totals, which must
+ *	start zeroed.
+ */
+void perf_sum(long long totals[PERF_NEVENTS], const perf_counters_t *pc);
+
+/**
+ * perf_print ... append totals to the current CSV line as ",v1,...,v5"
+ */
+void perf_print(const long long totals[PERF_NEVENTS]);
+
+#endif
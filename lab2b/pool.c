@@ -0,0 +1,187 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "pool.h"
+#include "lock.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE 64
+
+/* A worker's deque of chunks [next, end): its owner takes from next, thieves from end */
+struct pool_worker
+{
+    pool_t *pool;
+    int idx;
+    void (*init)(int worker);
+    volatile int lock;
+    int next, end;
+    int n, chunk; /* of the current pool_run, to turn chunks into ranges */
+} __attribute__((aligned(CACHE_LINE)));
+
+/* Next chunk of worker w's own deque, or -1 */
+static int take(struct pool_worker *w)
+{
+    int chunk = -1;
+    spin_acquire(&w->lock);
+    if (w->next < w->end)
+        chunk = w->next++;
+    spin_release(&w->lock);
+    return chunk;
+}
+
+/* Last chunk of victim's deque, or -1 */
+static int steal(struct pool_worker *victim)
+{
+    int chunk = -1;
+    spin_acquire(&victim->lock);
+    if (victim->next < victim->end)
+        chunk = --victim->end;
+    spin_release(&victim->lock);
+    return chunk;
+}
+
+static void run_chunks(struct pool_worker *w)
+{
+    pool_t *pool = w->pool;
+    int i, chunk;
+    for (;;)
+    {
+        chunk = take(w);
+        // Own deque empty: try everyone else's, nearest first
+        for (i = 1; -1 == chunk && i < pool->nworkers; ++i)
+            chunk = steal(&pool->workers[(w->idx + i) % pool->nworkers]);
+        // Chunks are only added between jobs, so all deques are now empty
+        if (-1 == chunk)
+            return;
+        int begin = chunk * w->chunk, end = begin + w->chunk;
+        pool->range_fn(pool->arg, begin, end < w->n ? end : w->n, w->idx);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    struct pool_worker *w = arg;
+    pool_t *pool = w->pool;
+    unsigned seen = 0;
+    if (w->init)
+        w->init(w->idx);
+    pthread_mutex_lock(&pool->mutex);
+    for (;;)
+    {
+        while (pool->generation == seen && !pool->shutdown)
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        if (pool->shutdown)
+            break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        if (pool->each_fn)
+            pool->each_fn(pool->arg, w->idx);
+        else
+            run_chunks(w);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (0 == --pool->busy)
+            pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+int pool_init(pool_t *pool, int nworkers, void (*init)(int worker))
+{
+    int i, err;
+    memset(pool, 0, sizeof(pool_t));
+    if (nworkers < 1)
+        return EINVAL;
+    pool->workers = aligned_alloc(CACHE_LINE, nworkers * sizeof(struct pool_worker));
+    pool->threads = malloc(nworkers * sizeof(pthread_t));
+    if (!pool->workers || !pool->threads)
+    {
+        free(pool->workers);
+        free(pool->threads);
+        return ENOMEM;
+    }
+    memset(pool->workers, 0, nworkers * sizeof(struct pool_worker));
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    for (i = 0; i < nworkers; ++i)
+    {
+        pool->workers[i].pool = pool;
+        pool->workers[i].idx = i;
+        pool->workers[i].init = init;
+        if (0 != (err = pthread_create(&pool->threads[i], NULL, worker_main, &pool->workers[i])))
+        {
+            pool->nworkers = i;
+            pool_destroy(pool);
+            return err;
+        }
+    }
+    pool->nworkers = nworkers;
+    return 0;
+}
+
+/* Post the job set up in pool and wait for every worker to finish it */
+static void post(pool_t *pool)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->busy = pool->nworkers;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->start);
+    while (pool->busy > 0)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+void pool_run(pool_t *pool, void (*fn)(void *arg, int begin, int end, int worker), void *arg, int n, int chunk)
+{
+    int i, nchunks;
+    if (n <= 0)
+        return;
+    if (chunk < 1)
+        chunk = 1;
+    nchunks = (n + chunk - 1) / chunk;
+    // Worker i starts with the i-th contiguous share of the chunks
+    for (i = 0; i < pool->nworkers; ++i)
+    {
+        struct pool_worker *w = &pool->workers[i];
+        w->next = (long long)nchunks * i / pool->nworkers;
+        w->end = (long long)nchunks * (i + 1) / pool->nworkers;
+        w->n = n;
+        w->chunk = chunk;
+    }
+    pool->range_fn = fn;
+    pool->each_fn = NULL;
+    pool->arg = arg;
+    post(pool);
+}
+
+void pool_each(pool_t *pool, void (*fn)(void *arg, int worker), void *arg)
+{
+    pool->range_fn = NULL;
+    pool->each_fn = fn;
+    pool->arg = arg;
+    post(pool);
+}
+
+void pool_destroy(pool_t *pool)
+{
+    int i;
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+    for (i = 0; i < pool->nworkers; ++i)
+        pthread_join(pool->threads[i], NULL);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->workers);
+    free(pool->threads);
+    pool->workers = NULL;
+    pool->threads = NULL;
+}
@@ -0,0 +1,72 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+
+struct pool_worker;
+
+/**
+ * pool_t
+ *
+ *	A fixed set of worker threads that outlives any one run, so a
+ *	benchmark can be run many times over without paying for thread
+ *	creation, and work-stealing, so no worker sits idle while another
+ *	still has a backlog.
+ *
+ *	pool_run splits [0, n) into chunks and hands each worker a
+ *	contiguous share of them, kept in that worker's deque. A worker
+ *	takes chunks from the front of its own deque; once it is empty it
+ *	steals from the back of the others', so stolen work is the work
+ *	its owner would have reached last. pool_each runs a function once
+ *	on every worker, e.g. to set up or collect per-worker state.
+ *
+ *	Both return only once all the work is done, and may only be called
+ *	by one thread at a time, which must not be a worker.
+ */
+typedef struct pool
+{
+    int nworkers;
+    struct pool_worker *workers;
+    pthread_t *threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t start; /* a new job, or shutdown */
+    pthread_cond_t done;  /* the last worker finished the job */
+    unsigned generation;  /* jobs posted so far */
+    int busy;             /* workers still on the current job */
+    int shutdown;
+    /* The current job */
+    void (*range_fn)(void *arg, int begin, int end, int worker);
+    void (*each_fn)(void *arg, int worker);
+    void *arg;
+} pool_t;
+
+/**
+ * pool_init ... start nworkers workers
+ *
+ *	Each worker calls init(worker) first, if init is not NULL, with
+ *	its index in [0, nworkers), e.g. to pin itself.
+ *
+ * @return 0, or an errno value
+ */
+int pool_init(pool_t *pool, int nworkers, void (*init)(int worker));
+
+/**
+ * pool_run ... call fn(arg, begin, end, worker) over [0, n) in chunks of up to chunk
+ */
+void pool_run(pool_t *pool, void (*fn)(void *arg, int begin, int end, int worker), void *arg, int n, int chunk);
+
+/**
+ * pool_each ... call fn(arg, worker) once on every worker
+ */
+void pool_each(pool_t *pool, void (*fn)(void *arg, int worker), void *arg);
+
+/**
+ * pool_destroy ... stop and join the workers
+ */
+void pool_destroy(pool_t *pool);
+
+#endif
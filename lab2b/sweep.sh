@@ -0,0 +1,203 @@
+#!/bin/bash
+#
+# NAME: Stephanie Doan
+# EMAIL: stephaniekdoan@ucla.edu
+# ID: 604981556
+#
+# purpose:
+#	run a matrix of driver configurations several times each and
+#	print one CSV line per configuration, in the driver's own format,
+#	so the .gp scripts read it like a single run's output
+#
+# usage: sweep.sh [-r runs] [-w warmups] [-c column] [-z column]
+#                 [-s stats.csv] [-b baseline.csv] [-t percent] spec
+#
+#	-r  timed runs of each configuration (default 5)
+#	-w  untimed warm-up runs before them (default 1)
+#	-c  column compared against the baseline (default 7, the time per
+#	    operation of lab2_list; 6 for lab2_add)
+#	-z  a correctness column, such as lab2_add's final counter (7),
+#	    that should be 0: print the run's value furthest from 0 instead
+#	    of the median, so one racy run is not outvoted by clean ones
+#	-s  write median, 95% confidence interval, runs and command of
+#	    each configuration here, to serve as a later baseline
+#	-b  baseline written by -s: report configurations whose interval
+#	    lies wholly above the baseline's and whose median is more than
+#	    -t percent (default 5) slower, and exit with 3
+#
+# spec: one driver command per line; # starts a comment. Every
+#	{a,b,...} group expands into one command per item, so
+#	  ./lab2_list --threads={1,2} --sync={m,s}
+#	is four configurations. An empty first item, as in {,--yield},
+#	leaves the option out. A line may start with runs=N and warmup=N
+#	to override -r and -w, as correctness probes do with runs=1.
+#
+# output:
+#	each column of the runs' lines replaced by its median (the lower
+#	one for an even count, so it is always a value some run printed),
+#	or for the -z column by its worst value.
+#	A run exiting with 2 found the list corrupted and prints nothing,
+#	and one killed by a signal (status over 128) crashed on it, so
+#	only the runs that succeeded count; a configuration none of
+#	whose runs succeeded prints nothing, as a single failed run did.
+#
+
+RUNS=5
+WARMUP=1
+COLUMN=7
+ZERO_COLUMN=0
+STATS=""
+BASELINE=""
+PERCENT=5
+
+usage() {
+    echo "usage: $0 [-r runs] [-w warmups] [-c column] [-z column] [-s stats.csv] [-b baseline.csv] [-t percent] spec" >&2
+    exit 1
+}
+
+while getopts "r:w:c:z:s:b:t:" opt
+do
+    case $opt in
+    r) RUNS=$OPTARG ;;
+    w) WARMUP=$OPTARG ;;
+    c) COLUMN=$OPTARG ;;
+    z) ZERO_COLUMN=$OPTARG ;;
+    s) STATS=$OPTARG ;;
+    b) BASELINE=$OPTARG ;;
+    t) PERCENT=$OPTARG ;;
+    *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -eq 1 ] && [ -r "$1" ] || usage
+SPEC=$1
+[ -z "$BASELINE" ] || [ -r "$BASELINE" ] || { echo "$0: can not read baseline $BASELINE" >&2; exit 1; }
+
+# Print every expansion of a spec line, one brace group at a time
+expand() {
+    local line=$1 head items tail item
+    if [[ $line =~ ^([^{]*)\{([^}]*)\}(.*)$ ]]
+    then
+        head=${BASH_REMATCH[1]}
+        tail=${BASH_REMATCH[3]}
+        IFS=',' read -ra items <<< "${BASH_REMATCH[2]}"
+        for item in "${items[@]}"
+        do
+            expand "$head$item$tail"
+        done
+    else
+        echo "$line"
+    fi
+}
+
+# Medians of the sample lines on stdin (the worst value of column zcol),
+# the interval of the compared column, and its comparison with the
+# baseline. The 95% interval of the median is the pair of order
+# statistics n/2 -+ 0.98 sqrt(n) (about 1.96 standard errors of the
+# rank), which needs no assumption about the distribution; with 5 runs
+# that is the fastest and slowest run.
+AGGREGATE='
+function sort(a, n,    i, j, x)
+{
+    for (i = 2; i <= n; ++i)
+    {
+        x = a[i]
+        for (j = i - 1; j >= 1 && a[j] > x; --j)
+            a[j + 1] = a[j]
+        a[j + 1] = x
+    }
+}
+BEGIN { FS = OFS = "," }
+{
+    name = $1
+    nf = NF
+    for (i = 2; i <= NF; ++i)
+        sample[i, NR] = $i + 0
+    n = NR
+}
+END {
+    if (!n)
+        exit 0
+    line = name
+    for (i = 2; i <= nf; ++i)
+    {
+        for (r = 1; r <= n; ++r)
+            a[r] = sample[i, r]
+        sort(a, n)
+        if (i == zcol)
+            line = line OFS (-a[1] > a[n] ? a[1] : a[n])
+        else
+            line = line OFS a[int((n + 1) / 2)]
+        if (i == col)
+        {
+            median = a[int((n + 1) / 2)]
+            lo = int(n / 2 - 0.98 * sqrt(n))
+            hi = n / 2 + 1 + 0.98 * sqrt(n)
+            hi = hi == int(hi) ? hi : int(hi) + 1
+            low = a[lo < 1 ? 1 : lo]
+            high = a[hi > n ? n : hi]
+        }
+    }
+    print line
+    if (stats != "")
+        print median, low, high, n, cmd >> stats
+    if (baseline == "" || n < 3)
+        exit 0
+    # Baseline rows are median,ci_low,ci_high,runs,command; the command may hold commas
+    while ((getline row < baseline) > 0)
+    {
+        split(row, b, ",")
+        if (substr(row, length(b[1] b[2] b[3] b[4]) + 5) != cmd || b[4] < 3)
+            continue
+        if (low > b[3] && median > b[1] * (1 + pct / 100))
+        {
+            printf "regression: %s: %s, was %s (+%.1f%%)\n", cmd, median, b[1], 100 * (median - b[1]) / b[1] > "/dev/stderr"
+            exit 3
+        }
+        if (high < b[2] && median < b[1] * (1 - pct / 100))
+            printf "improvement: %s: %s, was %s (%.1f%%)\n", cmd, median, b[1], 100 * (median - b[1]) / b[1] > "/dev/stderr"
+    }
+}'
+
+[ -z "$STATS" ] || echo "median,ci_low,ci_high,runs,command" > "$STATS"
+regressions=0
+while read -r spec_line
+do
+    spec_line=${spec_line%%#*}
+    [ -n "${spec_line// /}" ] || continue
+    while read -r config
+    do
+        runs=$RUNS
+        warmup=$WARMUP
+        while [[ $config =~ ^(runs|warmup)=([0-9]+)\ +(.*)$ ]]
+        do
+            [ "${BASH_REMATCH[1]}" = runs ] && runs=${BASH_REMATCH[2]} || warmup=${BASH_REMATCH[2]}
+            config=${BASH_REMATCH[3]}
+        done
+        for ((i = 0; i < runs + warmup; ++i))
+        do
+            line=$($config < /dev/null 2>/dev/null)
+            status=$?
+            # 2 is a corrupted list and over 128 a signal, such as SIGSEGV on one;
+            # both are expected of unprotected runs, anything else is a bad spec
+            if [ $status -ne 0 ] && [ $status -ne 2 ] && [ $status -le 128 ]
+            then
+                echo "$0: '$config' exited with $status" >&2
+                exit 1
+            fi
+            if [ $status -eq 0 ] && [ $i -ge "$warmup" ]
+            then
+                echo "$line"
+            fi
+        done | awk -v col="$COLUMN" -v zcol="$ZERO_COLUMN" -v cmd="$config" -v stats="$STATS" -v baseline="$BASELINE" -v pct="$PERCENT" "$AGGREGATE"
+        status=("${PIPESTATUS[@]}")
+        [ "${status[0]}" -eq 0 ] || exit 1
+        [ "${status[1]}" -eq 3 ] && regressions=$((regressions + 1))
+    done < <(expand "$spec_line")
+done < "$SPEC"
+
+if [ $regressions -gt 0 ]
+then
+    echo "$0: $regressions configurations regressed against $BASELINE" >&2
+    exit 3
+fi
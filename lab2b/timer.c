@@ -0,0 +1,96 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#include "timer.h"
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define TIMER_X86 1
+#endif
+
+#define CALIBRATE_NS 20000000 /* 20ms against CLOCK_MONOTONIC */
+
+int timer_sample = 1;
+
+static int tsc_enabled = 0;
+static double ns_per_tick = 1;
+static __thread int unsampled = 0; /* calls to timer_sampled since it last returned 1 */
+
+static long long clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+#ifdef TIMER_X86
+static int tsc_invariant(void)
+{
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007)
+        return 0;
+    __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+    if (!((edx >> 27) & 1)) /* RDTSCP, which tsc_read uses */
+        return 0;
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx >> 8) & 1;
+}
+
+/* rdtscp waits for earlier instructions, so the read is not hoisted into the interval */
+static unsigned long long tsc_read(void)
+{
+    unsigned aux;
+    return __rdtscp(&aux);
+}
+#endif
+
+int timer_init(int use_tsc)
+{
+    tsc_enabled = 0;
+    ns_per_tick = 1;
+#ifdef TIMER_X86
+    if (use_tsc && tsc_invariant())
+    {
+        long long start_ns = clock_ns(), end_ns;
+        unsigned long long start = tsc_read(), end;
+        do
+        {
+            end_ns = clock_ns();
+            end = tsc_read();
+        } while (end_ns - start_ns < CALIBRATE_NS);
+        if (end > start)
+        {
+            ns_per_tick = (double)(end_ns - start_ns) / (end - start);
+            tsc_enabled = 1;
+        }
+    }
+#else
+    (void)use_tsc;
+#endif
+    return tsc_enabled;
+}
+
+unsigned long long timer_now(void)
+{
+#ifdef TIMER_X86
+    if (tsc_enabled)
+        return tsc_read();
+#endif
+    return clock_ns();
+}
+
+long long timer_ns(long long ticks)
+{
+    return (long long)(ticks * ns_per_tick);
+}
+
+int timer_sampled(void)
+{
+    if (++unsampled < timer_sample)
+        return 0;
+    unsampled = 0;
+    return 1;
+}
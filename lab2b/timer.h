@@ -0,0 +1,59 @@
+// NAME: Stephanie Doan
+// EMAIL: stephaniekdoan@ucla.edu
+// ID: 604981556
+
+#ifndef TIMER_H
+#define TIMER_H
+
+/**
+ * Interval timer for instrumentation
+ *
+ *	On x86 CPUs whose time-stamp counter runs at a constant rate
+ *	through frequency changes and sleep states (invariant TSC, CPUID
+ *	leaf 0x80000007) and that have RDTSCP, timer_now reads the TSC, a few ns per read
+ *	against the tens of ns clock_gettime can cost, and timer_ns turns
+ *	tick differences into ns using a rate calibrated against
+ *	CLOCK_MONOTONIC by timer_init. Anywhere else it falls back to
+ *	CLOCK_MONOTONIC, in which case ticks are ns.
+ *
+ *	Before timer_init, or after timer_init(0), the fallback is used.
+ */
+
+/**
+ * timer_init ... pick and calibrate the timer
+ *
+ *	Takes a few ms when calibrating. Call once, before any thread
+ *	uses the timer.
+ *
+ * @return 1 if the TSC will be used, 0 for the fallback
+ */
+int timer_init(int use_tsc);
+
+/**
+ * timer_now ... current time in ticks
+ */
+unsigned long long timer_now(void);
+
+/**
+ * timer_ns ... convert end - start of two timer_now readings to ns
+ */
+long long timer_ns(long long ticks);
+
+/**
+ * timer_sample ... time one in every timer_sample intervals (default 1)
+ *
+ *	Set before any thread uses the timer. An interval picked by
+ *	timer_sampled stands for timer_sample of them, so its ns are
+ *	multiplied by timer_sample when summed.
+ */
+extern int timer_sample;
+
+/**
+ * timer_sampled ... whether the calling thread should time this interval
+ *
+ *	Each thread counts its calls, whatever is being timed, and every
+ *	timer_sample-th returns 1.
+ */
+int timer_sampled(void);
+
+#endif